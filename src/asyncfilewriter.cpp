@@ -0,0 +1,454 @@
+#include "asyncfilewriter.hpp"
+
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define COMPLOG_PRIVATE_HAS_IO_URING
+#endif
+#endif
+
+namespace Logger
+{
+
+/**
+ * @brief writeBlocking Записать данные в файл по смещению, повторяя частичные записи
+ * @return              false при ошибке записи
+ */
+static bool writeBlocking(int fd, const char* data, std::size_t size, std::uint64_t offset)
+{
+    while (size > 0) {
+        const auto written = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+    return true;
+}
+
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+/**
+ * @brief The UringQueue class Минимальная обёртка над кольцами io_uring (без liburing)
+ * @note  Используется одним потоком под lockFile() инстанции AsyncFileWriter
+ */
+class UringQueue
+{
+public:
+    UringQueue(const UringQueue&) = delete;
+    UringQueue& operator =(const UringQueue&) = delete;
+
+    UringQueue() = default;
+
+    ~UringQueue() {
+        if (m_sqes != nullptr) {
+            munmap(m_sqes, m_sqesSize);
+        }
+        if (m_cqRing != nullptr && m_cqRing != m_sqRing) {
+            munmap(m_cqRing, m_cqRingSize);
+        }
+        if (m_sqRing != nullptr) {
+            munmap(m_sqRing, m_sqRingSize);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    /**
+     * @brief init      Создать кольца
+     * @param entries   Размер очереди отправки
+     * @return          false, если io_uring недоступен (ENOSYS, EPERM и т.п.)
+     */
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (m_fd < 0) {
+            return false;
+        }
+
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool isSingleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (isSingleMmap) {
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+
+        m_sqRing = mapRing(m_sqRingSize, IORING_OFF_SQ_RING);
+        if (m_sqRing == nullptr) {
+            return false;
+        }
+        m_cqRing = isSingleMmap ? m_sqRing : mapRing(m_cqRingSize, IORING_OFF_CQ_RING);
+        if (m_cqRing == nullptr) {
+            return false;
+        }
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = static_cast<io_uring_sqe*>(mapRing(m_sqesSize, IORING_OFF_SQES));
+        if (m_sqes == nullptr) {
+            return false;
+        }
+
+        auto sq = static_cast<char*>(m_sqRing);
+        m_sqTail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sqMask  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto cq = static_cast<char*>(m_cqRing);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes   = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /**
+     * @brief submitWrite   Поставить запись в очередь и передать её ядру
+     * @note                Свободное место в очереди обеспечивает вызывающий
+     *                      (число записей в работе не больше размера очереди)
+     */
+    void submitWrite(int fd, const char* data, unsigned size, std::uint64_t offset, std::uint64_t userData) {
+        const auto tail = *m_sqTail;
+        const auto index = tail & m_sqMask;
+        auto& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(data);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+        m_sqArray[index] = index;
+        std::atomic_ref<unsigned>(*m_sqTail).store(tail + 1, std::memory_order_release);
+        ++m_pending;
+
+        enter(0);
+    }
+
+    /**
+     * @brief reap      Обработать завершённые записи без ожидания
+     * @param handler   Функтор (userData, результат записи)
+     */
+    template <typename F>
+    void reap(F&& handler) {
+        auto head = *m_cqHead;
+        const auto tail = std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire);
+        while (head != tail) {
+            const auto& cqe = m_cqes[head & m_cqMask];
+            handler(cqe.user_data, cqe.res);
+            ++head;
+        }
+        std::atomic_ref<unsigned>(*m_cqHead).store(head, std::memory_order_release);
+    }
+
+    /**
+     * @brief wait Дождаться хотя бы одного завершения
+     */
+    void wait() {
+        enter(1);
+    }
+
+private:
+    int         m_fd {-1};
+    void*       m_sqRing {nullptr};
+    std::size_t m_sqRingSize {0};
+    void*       m_cqRing {nullptr};
+    std::size_t m_cqRingSize {0};
+    io_uring_sqe* m_sqes {nullptr};
+    std::size_t m_sqesSize {0};
+
+    unsigned*   m_sqTail {nullptr};
+    unsigned    m_sqMask {0};
+    unsigned*   m_sqArray {nullptr};
+    unsigned*   m_cqHead {nullptr};
+    unsigned*   m_cqTail {nullptr};
+    unsigned    m_cqMask {0};
+    io_uring_cqe* m_cqes {nullptr};
+    unsigned    m_pending {0}; //! Записи в очереди отправки, ещё не принятые ядром
+
+    void* mapRing(std::size_t size, off_t offset) {
+        void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+        return ring == MAP_FAILED ? nullptr : ring;
+    }
+
+    void enter(unsigned minComplete) {
+        const unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        // Непринятые записи остаются в очереди и передаются при следующем вызове
+        const auto submitted = syscall(__NR_io_uring_enter, m_fd, m_pending, minComplete, flags, nullptr, 0);
+        if (submitted > 0) {
+            m_pending -= static_cast<unsigned>(submitted);
+        }
+    }
+};
+#endif // COMPLOG_PRIVATE_HAS_IO_URING
+
+/**
+ * @brief The WriteSlot struct Буфер пакета записей
+ */
+struct WriteSlot
+{
+    std::vector<char> data;
+    std::size_t size {0};         //! Заполненная часть буфера
+    std::uint64_t offset {0};     //! Смещение в файле, по которому буфер записывается
+    bool isInFlight {false};      //! Буфер отправлен и ещё записывается
+};
+
+struct AsyncFileWriter::Impl
+{
+    static constexpr std::size_t NO_SLOT {SIZE_MAX};
+
+    std::vector<WriteSlot> slots;
+    std::size_t current {NO_SLOT}; //! Заполняемый буфер
+    std::size_t inFlightCount {0};
+    int fd {-1};
+    std::uint64_t offset {0};      //! Конец данных файла с учётом отправленных буферов
+    std::uint64_t lostSize {0};    //! Данные, которые не удалось записать (сообщается при следующем вызове)
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+    std::unique_ptr<UringQueue> ring;
+#endif
+
+    bool isAsync() const {
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+        return ring != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    void complete(std::size_t index, int result) {
+        auto& slot = slots[index];
+        // При ошибке или частичной записи остаток записывается блокирующим способом
+        const auto written = result < 0 ? 0 : static_cast<std::size_t>(result);
+        if (written < slot.size &&
+            !writeBlocking(fd, slot.data.data() + written, slot.size - written, slot.offset + written)) {
+            lostSize += slot.size - written;
+        }
+        slot.size = 0;
+        slot.isInFlight = false;
+        --inFlightCount;
+    }
+
+    void reap() {
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+        if (ring != nullptr && inFlightCount > 0) {
+            ring->reap([this](std::uint64_t index, int result) {
+                complete(static_cast<std::size_t>(index), result);
+            });
+        }
+#endif
+    }
+
+    void waitCompletion() {
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+        ring->wait();
+#endif
+        reap();
+    }
+
+    WriteSlot& acquireSlot() {
+        if (current != NO_SLOT) {
+            return slots[current];
+        }
+        reap();
+        while (true) {
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                if (!slots[i].isInFlight) {
+                    current = i;
+                    return slots[i];
+                }
+            }
+            waitCompletion();
+        }
+    }
+
+    void submitCurrent() {
+        if (current == NO_SLOT) {
+            return;
+        }
+        auto& slot = slots[current];
+        const auto index = current;
+        current = NO_SLOT;
+        if (slot.size == 0) {
+            return;
+        }
+
+        slot.offset = offset;
+        offset += slot.size;
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+        if (ring != nullptr) {
+            slot.isInFlight = true;
+            ++inFlightCount;
+            ring->submitWrite(fd, slot.data.data(), static_cast<unsigned>(slot.size), slot.offset, index);
+            return;
+        }
+#endif
+        if (!writeBlocking(fd, slot.data.data(), slot.size, slot.offset)) {
+            lostSize += slot.size;
+        }
+        slot.size = 0;
+    }
+
+    void waitAll() {
+        submitCurrent();
+        while (inFlightCount > 0) {
+            waitCompletion();
+        }
+    }
+};
+
+AsyncFileWriter::AsyncFileWriter(Backend backend, std::size_t buffersCount, std::size_t bufferSize) :
+    d {new Impl}
+{
+    d->slots.resize(std::max<std::size_t>(buffersCount, 1));
+    for (auto& slot : d->slots) {
+        slot.data.resize(std::max<std::size_t>(bufferSize, 1));
+    }
+
+#ifdef COMPLOG_PRIVATE_HAS_IO_URING
+    if (backend == Backend::Auto) {
+        d->ring = std::make_unique<UringQueue>();
+        if (!d->ring->init(static_cast<unsigned>(d->slots.size()))) {
+            d->ring.reset();
+        }
+    }
+#else
+    (void)backend;
+#endif
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    close();
+}
+
+void AsyncFileWriter::setLogfile(const std::string &filePath)
+{
+    lockFile();
+    closeLogfile();
+    FileWriterBase::setLogfile(filePath);
+    unlockFile();
+}
+
+void AsyncFileWriter::setLogfile(const std::string_view &filePath)
+{
+    setLogfile(std::string(filePath));
+}
+
+bool AsyncFileWriter::isAsync() const
+{
+    return d->isAsync();
+}
+
+void AsyncFileWriter::write(const char *data, std::size_t size)
+{
+    lockFile();
+    if (isRotationNeeded(size)) {
+        closeLogfile();
+        rotateLogfile();
+    }
+    if (d->fd < 0 && !openLogfile()) {
+        unlockFile();
+        throw std::runtime_error(
+                    std::string("Error opening logfile (logfile path: ") +
+                    getLogfilePath().data() + ")");
+    }
+
+    countWrittenSize(size);
+    while (size > 0) {
+        auto& slot = d->acquireSlot();
+        const auto chunk = std::min(size, slot.data.size() - slot.size);
+        std::memcpy(slot.data.data() + slot.size, data, chunk);
+        slot.size += chunk;
+        data += chunk;
+        size -= chunk;
+        if (slot.size == slot.data.size()) {
+            d->submitCurrent();
+        }
+    }
+    checkLostData();
+}
+
+void AsyncFileWriter::flush()
+{
+    lockFile();
+    d->submitCurrent();
+    d->reap();
+    checkLostData();
+}
+
+void AsyncFileWriter::sync()
+{
+    lockFile();
+    d->waitAll();
+    checkLostData();
+}
+
+void AsyncFileWriter::close()
+{
+    lockFile();
+    closeLogfile();
+    unlockFile();
+}
+
+bool AsyncFileWriter::openLogfile()
+{
+    if (!hasLogfile()) {
+        return false;
+    }
+    d->fd = ::open(getLogfilePath().data(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (d->fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    d->offset = fstat(d->fd, &fileStat) == 0 ? static_cast<std::uint64_t>(fileStat.st_size) : 0;
+    countOpenedSize();
+    return true;
+}
+
+void AsyncFileWriter::checkLostData()
+{
+    const auto lostSize = std::exchange(d->lostSize, 0);
+    unlockFile();
+    if (lostSize > 0) {
+        throw std::runtime_error(
+                    std::string("Error writing logfile, ") + std::to_string(lostSize) +
+                    " bytes lost (logfile path: " + getLogfilePath().data() + ")");
+    }
+}
+
+void AsyncFileWriter::closeLogfile()
+{
+    if (d->fd < 0) {
+        return;
+    }
+    d->waitAll();
+    ::close(d->fd);
+    d->fd = -1;
+}
+
+}
+
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * @file asyncfilewriter.hpp Файл с определением асинхронной записи логфайла через io_uring
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define COMPLOG_PRIVATE_HAS_ASYNC_FILE
+#endif
+
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "filewriterbase.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The AsyncFileWriter class Запись отформатированного текста в логфайл без ожидания диска
+ * @note  Текст копируется в один из нескольких буферов. Заполненный буфер (или текущий при flush)
+ *        отправляется на запись через io_uring, и поток вывода сразу форматирует следующий пакет
+ *        в другой буфер. Ожидание происходит, только если все буферы ещё записываются.
+ *        Если io_uring недоступен при сборке или запрещён при работе (старое ядро, seccomp),
+ *        буфер записывается блокирующим pwrite
+ */
+class AsyncFileWriter final : public FileWriterBase
+{
+public:
+    /**
+     * @brief The Backend enum Способ записи буферов
+     */
+    enum class Backend {
+        Auto,     //! io_uring, если доступен, иначе блокирующая запись
+        Blocking, //! Всегда блокирующая запись
+    };
+
+    //! Количество буферов по умолчанию
+    static constexpr std::size_t DEFAULT_BUFFERS_COUNT {4};
+    //! Размер буфера по умолчанию
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE {256 * 1024};
+
+    explicit AsyncFileWriter(Backend backend = Backend::Auto,
+                             std::size_t buffersCount = DEFAULT_BUFFERS_COUNT,
+                             std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~AsyncFileWriter();
+
+    void setLogfile(const std::string& filePath) override;
+    void setLogfile(const std::string_view& filePath) override;
+
+    /**
+     * @brief isAsync Проверка, что запись выполняется через io_uring
+     */
+    bool isAsync() const;
+
+    /**
+     * @brief write Записать в файл отформатированный текст (например, пакет записей)
+     * @param data  Текст
+     * @param size  Размер текста
+     * @throw       std::runtime_error, если логфайл не открывается или запись ранее отправленных
+     *              буферов завершилась ошибкой (также для flush и sync)
+     */
+    void write(const char* data, std::size_t size);
+
+    /**
+     * @brief flush Отправить на запись текущий буфер, не дожидаясь завершения
+     */
+    void flush();
+
+    /**
+     * @brief sync Дождаться завершения всех отправленных записей
+     */
+    void sync();
+
+    /**
+     * @brief close Дождаться записи и закрыть файл
+     */
+    void close();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> d;
+
+    bool openLogfile();
+    void closeLogfile();
+
+    /**
+     * @brief checkLostData Снять lockFile() и сообщить исключением о данных, которые не удалось записать
+     */
+    void checkLostData();
+};
+
+}
+
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file binaryformat.hpp Файл с описанием формата двоичного логфайла
+ *
+ * Файл начинается с BINARY_LOG_MAGIC, далее следуют записи. Каждая запись начинается с байта BinaryEntry.
+ * Числа записываются в порядке байт платформы, на которой создан лог.
+ *
+ * BinaryEntry::CallSite - описание места вызова, пишется перед первой записью с этого места:
+ *     u64 идентификатор, u8 уровень, u32 строка, u32 длина имени файла, имя файла,
+ *     u8 количество аргументов, типы аргументов (ArgType, по байту)
+ *
+ * BinaryEntry::Record - запись лога:
+ *     u64 идентификатор места вызова (0, если не задано), u8 уровень,
+ *     i64 системное время в наносекундах, u64 порядковый номер, u32 размер аргументов,
+ *     аргументы (формат описан в payload.hpp)
+ *
+ * BinaryEntry::SampledRecord - запись, сохранённая выборкой (см. InstanceBase::setSampling):
+ *     поля BinaryEntry::Record до размера аргументов включительно, u32 N (сохранена одна из N), аргументы
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Logger
+{
+
+//! Сигнатура двоичного логфайла
+constexpr char BINARY_LOG_MAGIC[8] {'C', 'O', 'M', 'P', 'L', 'O', 'G', '1'};
+
+//! Расширение двоичного логфайла
+constexpr const char* BINARY_LOG_EXTENSION {".clog"};
+
+/**
+ * @brief The BinaryEntry enum Тип записи двоичного логфайла
+ */
+enum class BinaryEntry : std::uint8_t { CallSite = 1, Record = 2, SampledRecord = 3 };
+
+//! Размер заголовка BinaryEntry::Record (без байта типа и аргументов)
+constexpr std::size_t BINARY_RECORD_HEADER_SIZE {8 + 1 + 8 + 8 + 4};
+
+//! Дополнительное поле BinaryEntry::SampledRecord
+constexpr std::size_t BINARY_SAMPLE_RATE_SIZE {4};
+
+//! Размер полей фиксированного размера BinaryEntry::CallSite (без байта типа)
+constexpr std::size_t BINARY_CALLSITE_HEADER_SIZE {8 + 1 + 4 + 4 + 1};
+
+//! Максимальный размер аргументов BinaryEntry::Record. Записи большего размера не пишутся,
+//! при чтении считаются повреждением файла
+constexpr std::size_t BINARY_MAX_PAYLOAD_SIZE {64 * 1024 * 1024};
+
+//! Максимальная длина имени файла BinaryEntry::CallSite. Более длинные имена обрезаются
+constexpr std::size_t BINARY_MAX_FILE_NAME_SIZE {4096};
+
+}
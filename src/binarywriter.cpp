@@ -0,0 +1,162 @@
+#include "binarywriter.hpp"
+
+#include <filesystem>
+
+namespace Logger
+{
+
+// Размер буфера записи в файл
+constexpr std::size_t BINARY_LOGFILE_BUFFER_SIZE {256 * 1024};
+
+/**
+ * @brief The ArgTypeVisitor struct Получение типа аргумента при обходе записи
+ */
+struct ArgTypeVisitor
+{
+    ArgType operator()(bool) const { return ArgType::Bool; }
+    ArgType operator()(char) const { return ArgType::Char; }
+    ArgType operator()(std::int64_t) const { return ArgType::Int; }
+    ArgType operator()(std::uint64_t) const { return ArgType::UInt; }
+    ArgType operator()(double) const { return ArgType::Double; }
+    ArgType operator()(std::string_view) const { return ArgType::String; }
+    ArgType operator()(const void*) const { return ArgType::Pointer; }
+    ArgType operator()(FieldKey) const { return ArgType::Key; }
+};
+
+BinaryWriter::BinaryWriter() :
+    m_logfileBuffer(BINARY_LOGFILE_BUFFER_SIZE)
+{
+
+}
+
+BinaryWriter::~BinaryWriter()
+{
+    lockFile();
+    if (m_logfile.is_open()) {
+        m_logfile.close();
+    }
+    unlockFile();
+}
+
+void BinaryWriter::setLogfile(const std::string &filePath)
+{
+    lockFile();
+    if (m_logfile.is_open()) {
+        m_logfile.close();
+    }
+    FileWriterBase::setLogfile(filePath);
+    unlockFile();
+}
+
+void BinaryWriter::setLogfile(const std::string_view &filePath)
+{
+    setLogfile(std::string(filePath));
+}
+
+void BinaryWriter::write(const Record &record, std::chrono::system_clock::time_point timestamp)
+{
+    if (record.payloadSize() > BINARY_MAX_PAYLOAD_SIZE) {
+        return;
+    }
+
+    lockFile();
+    const bool isSampled = record.sampleRate() > 1;
+    const auto entrySize = 1 + BINARY_RECORD_HEADER_SIZE + (isSampled ? BINARY_SAMPLE_RATE_SIZE : 0) + record.payloadSize();
+    if (isRotationNeeded(entrySize)) {
+        // Новый файл начинается с сигнатуры и собственного словаря мест вызова
+        if (m_logfile.is_open()) {
+            m_logfile.close();
+        }
+        rotateLogfile();
+    }
+    if (!m_logfile.is_open() && !openLogfile()) {
+        unlockFile();
+        throw std::runtime_error(
+                    std::string("Error opening binary logfile (logfile path: ") +
+                    getLogfilePath().data() + ")");
+    }
+
+    if (record.site() && m_writtenSites.insert(record.site()).second) {
+        writeCallSite(record);
+    }
+
+    m_logfile.put(static_cast<char>(isSampled ? BinaryEntry::SampledRecord : BinaryEntry::Record));
+    writeValue(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(record.site())));
+    writeValue(static_cast<std::uint8_t>(record.level()));
+    writeValue(static_cast<std::int64_t>(
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count()));
+    writeValue(record.sequence());
+    writeValue(static_cast<std::uint32_t>(record.payloadSize()));
+    if (isSampled) {
+        writeValue(record.sampleRate());
+    }
+    m_logfile.write(reinterpret_cast<const char*>(record.payload()), record.payloadSize());
+    countWrittenSize(entrySize);
+
+    // При ошибке записи файл будет переоткрыт перед следующей записью
+    if (!m_logfile.good()) {
+        m_logfile.close();
+    }
+    unlockFile();
+}
+
+void BinaryWriter::flush()
+{
+    lockFile();
+    if (m_logfile.is_open()) {
+        m_logfile.flush();
+    }
+    unlockFile();
+}
+
+bool BinaryWriter::openLogfile()
+{
+    if (!hasLogfile()) {
+        return false;
+    }
+    const auto filePath = getLogfilePath();
+
+    std::error_code errCode;
+    const auto isNewFile = std::filesystem::file_size(filePath, errCode) == 0 || errCode;
+
+    m_logfile.clear();
+    m_logfile.rdbuf()->pubsetbuf(m_logfileBuffer.data(), m_logfileBuffer.size());
+    m_logfile.open(filePath.data(), std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+    if (!m_logfile.is_open()) {
+        return false;
+    }
+
+    countOpenedSize();
+    if (isNewFile) {
+        m_logfile.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+        countWrittenSize(sizeof(BINARY_LOG_MAGIC));
+    }
+    m_writtenSites.clear();
+    return true;
+}
+
+void BinaryWriter::writeCallSite(const Record &record)
+{
+    const auto site = record.site();
+    const auto file = std::string_view(site->file).substr(0, BINARY_MAX_FILE_NAME_SIZE);
+
+    std::uint8_t argsCount {0};
+    ArgType argTypes[UINT8_MAX];
+    record.visitArgs([&](const auto& v) {
+        if (argsCount < UINT8_MAX) {
+            argTypes[argsCount++] = ArgTypeVisitor{}(v);
+        }
+    });
+
+    m_logfile.put(static_cast<char>(BinaryEntry::CallSite));
+    writeValue(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(site)));
+    writeValue(static_cast<std::uint8_t>(site->level));
+    writeValue(static_cast<std::uint32_t>(site->line));
+    writeValue(static_cast<std::uint32_t>(file.size()));
+    m_logfile.write(file.data(), file.size());
+    writeValue(argsCount);
+    m_logfile.write(reinterpret_cast<const char*>(argTypes), argsCount);
+    countWrittenSize(1 + BINARY_CALLSITE_HEADER_SIZE + file.size() + argsCount);
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <unordered_set>
+#include <vector>
+
+#include "filewriterbase.hpp"
+#include "binaryformat.hpp"
+#include "record.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The BinaryWriter class Запись логов в двоичном виде без форматирования текста
+ * @note  Формат описан в binaryformat.hpp, для перевода в текст используется LoggerDecoder
+ */
+class BinaryWriter final : public FileWriterBase
+{
+public:
+    BinaryWriter();
+    ~BinaryWriter();
+
+    void setLogfile(const std::string& filePath) override;
+    void setLogfile(const std::string_view& filePath) override;
+
+    /**
+     * @brief write     Записать запись лога
+     * @param record    Запись
+     * @param timestamp Момент создания записи
+     */
+    void write(const Record& record, std::chrono::system_clock::time_point timestamp);
+
+    /**
+     * @brief flush Сбросить буферизованные данные в файл
+     */
+    void flush();
+
+private:
+    std::ofstream                       m_logfile;
+    std::vector<char>                   m_logfileBuffer;  //! Буфер записи в пространстве процесса
+    std::unordered_set<const CallSite*> m_writtenSites;   //! Места вызова, описание которых уже в файле
+
+    bool openLogfile();
+    void writeCallSite(const Record& record);
+
+    template <typename T>
+    void writeValue(const T& v) {
+        m_logfile.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+};
+
+}
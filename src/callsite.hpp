@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * @file callsite.hpp Файл с определением статического описания места вызова лога
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <source_location>
+#include <string_view>
+
+#include "common.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The CallSiteState struct Изменяемое состояние места вызова для подавления потока повторяющихся записей
+ * @note  Обновляется вызывающими потоками без блокировок, счётчики при одновременных вызовах приблизительны
+ */
+struct CallSiteState
+{
+    std::atomic<std::uint64_t> rateTicks {0};        //! Расчётный момент следующей записи (token bucket в форме GCRA)
+    std::atomic<std::uint64_t> rateSuppressed {0};   //! Записи, отброшенные ограничением частоты
+    std::atomic<std::uint64_t> lastHash {0};         //! Хэш уровня и аргументов последней записи
+    std::atomic<std::uint64_t> lastWrittenTicks {0}; //! Момент последней выведенной записи
+    std::atomic<std::uint64_t> repeatedCount {0};    //! Повторы последней выведенной записи, свёрнутые в одну строку
+    std::atomic<std::uint64_t> filterCache {0};      //! Версия правил InstanceBase::setSiteLevel и порог места вызова по ним
+};
+
+/**
+ * @brief The CallSite struct Статическое описание места вызова COMPLOG_*. Создаётся один раз на место вызова
+ *        при компиляции (constinit), запись хранит только указатель на него
+ */
+struct CallSite
+{
+    Level       level;
+    const char* file;
+    unsigned    line;
+    std::string_view function {}; //! Функция, содержащая вызов (пустая, если не задана)
+    mutable CallSiteState state {}; //! Используется InstanceBase::setRateLimit, setDeduplication и setSiteLevel
+};
+
+/**
+ * @brief getCallerFunction Имя функции места вызова без лямбд, в которые вызов оборачивают макросы COMPLOG_*
+ * @param name              std::source_location::function_name() внутри этих лямбд,
+ *                          например "main()::<lambda()>::<lambda()>" (GCC) -> "main()"
+ */
+constexpr std::string_view getCallerFunction(std::string_view name) {
+    auto pos = name.find("::<lambda");
+    if (pos == std::string_view::npos) {
+        pos = name.find("::(anonymous class)");
+    }
+    return name.substr(0, pos);
+}
+
+}
+
+/**
+ * @brief COMPLOG_PRIVATE_CALLSITE Получить статическое описание текущего места вызова
+ */
+#define COMPLOG_PRIVATE_CALLSITE(logLevel)                                                  \
+    []() -> const Logger::CallSite& {                                                       \
+        static constinit Logger::CallSite complogCallSite {Logger::Level::logLevel, __FILE__, __LINE__, \
+            Logger::getCallerFunction(std::source_location::current().function_name())};   \
+        return complogCallSite;                                                             \
+    }()
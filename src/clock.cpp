@@ -0,0 +1,90 @@
+#include "clock.hpp"
+
+#ifdef COMPLOG_PRIVATE_CLOCK_HAS_TSC
+#include <cpuid.h>
+#endif // COMPLOG_PRIVATE_CLOCK_HAS_TSC
+
+namespace Logger
+{
+
+// Минимальный интервал для оценки частоты TSC
+constexpr std::chrono::milliseconds TSC_MIN_MEASURE_TIME {1};
+
+// Период обновления опорной точки ClockCalibration
+constexpr std::chrono::seconds CALIBRATION_PERIOD {1};
+
+/**
+ * @brief The TscAnchor struct Опорная точка для оценки частоты TSC, фиксируется при первом обращении
+ */
+struct TscAnchor
+{
+    std::uint64_t                         ticks;
+    std::chrono::steady_clock::time_point steadyTime;
+
+    static const TscAnchor& instance() {
+        static const TscAnchor anchor {Clock::now(), std::chrono::steady_clock::now()};
+        return anchor;
+    }
+};
+
+Clock::Source Clock::detectSource()
+{
+    auto source = Source::Steady;
+#ifdef COMPLOG_PRIVATE_CLOCK_HAS_TSC
+    // CPUID 0x80000007, EDX bit 8: invariant TSC
+    unsigned eax {0}, ebx {0}, ecx {0}, edx {0};
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8))) {
+        source = Source::Tsc;
+    }
+#endif // COMPLOG_PRIVATE_CLOCK_HAS_TSC
+
+    auto expected = Source::Unknown;
+    if (!s_source.compare_exchange_strong(expected, source, std::memory_order_relaxed)) {
+        return expected;
+    }
+    return source;
+}
+
+double Clock::nanosecondsPerTick()
+{
+    now();
+    if (s_source.load(std::memory_order_relaxed) != Source::Tsc) {
+        using steady_period = std::chrono::steady_clock::period;
+        return 1e9 * steady_period::num / steady_period::den;
+    }
+
+    const auto& anchor = TscAnchor::instance();
+    auto steadyNow = std::chrono::steady_clock::now();
+    while (steadyNow - anchor.steadyTime < TSC_MIN_MEASURE_TIME) {
+        steadyNow = std::chrono::steady_clock::now();
+    }
+    const auto ticksNow = now();
+
+    const auto elapsedNs = std::chrono::duration<double, std::nano>(steadyNow - anchor.steadyTime).count();
+    return elapsedNs / static_cast<double>(ticksNow - anchor.ticks);
+}
+
+std::chrono::system_clock::time_point ClockCalibration::toSystemTime(std::uint64_t ticks)
+{
+    if (!m_isCalibrated || (ticks > m_refTicks && ticks - m_refTicks > m_periodTicks)) {
+        calibrate();
+    }
+
+    const auto deltaTicks = static_cast<std::int64_t>(ticks - m_refTicks);
+    const auto systemNs = m_refSystemNs + static_cast<std::int64_t>(static_cast<double>(deltaTicks) * m_nsPerTick);
+    return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(systemNs)));
+}
+
+void ClockCalibration::calibrate()
+{
+    m_nsPerTick = Clock::nanosecondsPerTick();
+    m_refTicks = Clock::now();
+    m_refSystemNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    m_periodTicks = static_cast<std::uint64_t>(
+                std::chrono::duration<double, std::nano>(CALIBRATION_PERIOD).count() / m_nsPerTick);
+    m_isCalibrated = true;
+}
+
+}
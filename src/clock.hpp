@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file clock.hpp Файл с определением дешёвых часов для фиксации момента записи в вызывающем потоке
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define COMPLOG_PRIVATE_CLOCK_HAS_TSC
+#endif // x86 && (GCC || Clang)
+
+namespace Logger
+{
+
+/**
+ * @brief The Clock class Монотонные часы для фиксации момента записи
+ * @note  Используется счётчик TSC, если он инвариантен, иначе std::chrono::steady_clock.
+ *        Перевод тиков во время выполняется потоком вывода через ClockCalibration
+ */
+class Clock
+{
+public:
+    /**
+     * @brief now   Получить текущее значение часов
+     * @return      Тики, сравнимые только между собой
+     */
+    static std::uint64_t now() {
+#ifdef COMPLOG_PRIVATE_CLOCK_HAS_TSC
+        auto source = s_source.load(std::memory_order_relaxed);
+        if (source == Source::Unknown) {
+            source = detectSource();
+        }
+        if (source == Source::Tsc) {
+            return __rdtsc();
+        }
+#endif // COMPLOG_PRIVATE_CLOCK_HAS_TSC
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    /**
+     * @brief nextSequence  Получить порядковый номер записи (общий для процесса)
+     */
+    static std::uint64_t nextSequence() {
+        return s_sequence.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief nanosecondsPerTick    Оценка длительности одного тика
+     * @note                        Для TSC уточняется со временем работы процесса
+     */
+    static double nanosecondsPerTick();
+
+private:
+    enum class Source : int { Unknown, Tsc, Steady };
+
+    static inline std::atomic<Source>        s_source {Source::Unknown};
+    static inline std::atomic<std::uint64_t> s_sequence {0};
+
+    static Source detectSource();
+};
+
+/**
+ * @brief The ClockCalibration class Перевод тиков Clock в системное время
+ * @note  Опорная точка обновляется раз в секунду, поэтому учитываются коррекции системного времени.
+ *        Не потокобезопасен: используется одним потоком вывода либо под его блокировкой
+ */
+class ClockCalibration
+{
+public:
+    /**
+     * @brief toSystemTime  Перевести тики в системное время
+     * @param ticks         Значение Clock::now()
+     */
+    std::chrono::system_clock::time_point toSystemTime(std::uint64_t ticks);
+
+private:
+    bool          m_isCalibrated {false};
+    std::uint64_t m_refTicks {0};
+    std::int64_t  m_refSystemNs {0};
+    double        m_nsPerTick {1.0};
+    std::uint64_t m_periodTicks {0};
+
+    void calibrate();
+};
+
+}
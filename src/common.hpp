@@ -1,13 +1,17 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <chrono>
+
+#include "timestamp.hpp"
 
 #ifdef COMPONENTS_IS_ENABLED_QT
 #include <QDateTime>
 #else
 #include <iostream>
 #include <iomanip>
-#include <chrono>
 #include <sstream>
 #endif // COMPONENTS_IS_ENABLED_QT
 
@@ -21,6 +25,67 @@ namespace Logger
  */
 enum class Level { Empty, Debug, Info, Warning, Error, Ok };
 
+//! Количество уровней записей (для счётчиков и настроек по уровням)
+constexpr std::size_t LEVELS_COUNT {static_cast<std::size_t>(Level::Ok) + 1};
+
+/**
+ * @brief getLevelName  Название уровня ("Debug", "Info", ...) для сводок и структурированного вывода
+ */
+constexpr std::string_view getLevelName(Level level) {
+    switch (level) {
+        case Level::Empty:
+            return "Empty";
+        case Level::Debug:
+            return "Debug";
+        case Level::Info:
+            return "Info";
+        case Level::Warning:
+            return "Warning";
+        case Level::Error:
+            return "Error";
+        case Level::Ok:
+            return "Ok";
+    }
+    return {};
+}
+
+/**
+ * @brief getLevelSeverity  Важность уровня для сравнения с порогом вывода
+ * @note                    Empty и Ok считаются равными Info
+ */
+constexpr int getLevelSeverity(Level level) {
+    switch (level) {
+        case Level::Debug:
+            return 0;
+        case Level::Empty:
+        case Level::Info:
+        case Level::Ok:
+            return 1;
+        case Level::Warning:
+            return 2;
+        case Level::Error:
+            return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief isLevelEnabled    Проверка уровня на этапе компиляции
+ * @return                  true, если уровень LogType не ниже порога MinLevel
+ */
+template<Level LogType, Level MinLevel>
+constexpr bool isLevelEnabled() {
+    return getLevelSeverity(LogType) >= getLevelSeverity(MinLevel);
+}
+
+/**
+ * @brief The OutputFormat enum Формат логфайла
+ */
+enum class OutputFormat {
+    Text,   //! Текст (консоль и файл)
+    Binary, //! Двоичный файл без форматирования, перевод в текст через LoggerDecoder
+};
+
 /**
  * @brief createLogtypeColoredString    Получение выделенного цветом текста для логов
  * @return                              Строка с управляющими символами
@@ -69,15 +134,15 @@ constexpr const char* createLogtypeString() {
 
 /**
  * @brief createLofgileName Функция создания названия для логфайла
+ * @param now               Момент времени, по которому строится название
  * @return                  Строка названия. Пример: 2026-12-31_23-59-59.log
  */
-static std::string createLogfileName() {
+inline std::string createLogfileName(std::chrono::system_clock::time_point now) {
 #ifdef COMPONENTS_IS_ENABLED_QT
-    return QDateTime::currentDateTime()
+    return QDateTime::fromMSecsSinceEpoch(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count())
         .toString("yyyy-MM-dd_hh-mm-ss.log")
         .toStdString();
 #else
-    auto now = std::chrono::system_clock::now();
     auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
 
     std::time_t now_c = std::chrono::system_clock::to_time_t(now_ms);
@@ -98,38 +163,94 @@ static std::string createLogfileName() {
 #endif // COMPONENTS_IS_ENABLED_QT
 }
 
+/**
+ * @brief createLofgileName Функция создания названия для логфайла по текущему моменту времени
+ * @return                  Строка названия. Пример: 2026-12-31_23-59-59.log
+ */
+inline std::string createLogfileName() {
+    return createLogfileName(std::chrono::system_clock::now());
+}
+
 
 /**
- * @brief getTimestamp  Функция получения текущего момента времени
+ * @brief getTimestamp  Функция получения строкового представления момента времени
+ * @param now           Момент времени
  * @return              Момент времени в стандартном формате
  */
-static std::string getTimestamp() {
-#ifdef COMPONENTS_IS_ENABLED_QT
-    return QDateTime::currentDateTime()
-        .toString("yyyy-MM-dd_hh:mm:ss")
-        .toStdString();
-#else
-    auto now = std::chrono::system_clock::now();
-    auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
-
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now_ms);
-    std::tm now_tm;
+inline std::string getTimestamp(std::chrono::system_clock::time_point now) {
+    thread_local TimestampFormatter formatter;
+    char buffer[TimestampFormatter::TIMESTAMP_SIZE];
+    return std::string(buffer, formatter.format(now, buffer));
+}
 
-    // Use localtime_s for thread safety (Windows)
-#ifdef _WIN32
-    localtime_s(&now_tm, &now_c);
-#else
-    // Use localtime_r for thread safety (POSIX)
-    localtime_r(&now_c, &now_tm);
-#endif
+/**
+ * @brief createLogtypeColoredString    Получение выделенного цветом текста для логов
+ * @param logType                       Тип записи
+ * @return                              Строка с управляющими символами
+ */
+constexpr const char* createLogtypeColoredString(Level logType) {
+    switch (logType) {
+        case Level::Empty:
+            return "";
+        case Level::Debug:
+            return createLogtypeColoredString<Level::Debug>();
+        case Level::Info:
+            return createLogtypeColoredString<Level::Info>();
+        case Level::Warning:
+            return createLogtypeColoredString<Level::Warning>();
+        case Level::Error:
+            return createLogtypeColoredString<Level::Error>();
+        case Level::Ok:
+            return createLogtypeColoredString<Level::Ok>();
+    }
+    return "";
+}
 
-    std::ostringstream oss;
-    oss << std::put_time(&now_tm, "%Y-%m-%dT%H:%M:%S") // Unified format
-        << '.' << std::setfill('0') << std::setw(3)
-        << (now_ms.time_since_epoch().count() % 1000);
+/**
+ * @brief createLogtypeString   Получение не выделенного цветом текста для логов
+ * @param logType               Тип записи
+ * @return                      Строка без управляющих последовательностей
+ */
+constexpr const char* createLogtypeString(Level logType) {
+    switch (logType) {
+        case Level::Empty:
+            return "";
+        case Level::Debug:
+            return createLogtypeString<Level::Debug>();
+        case Level::Info:
+            return createLogtypeString<Level::Info>();
+        case Level::Warning:
+            return createLogtypeString<Level::Warning>();
+        case Level::Error:
+            return createLogtypeString<Level::Error>();
+        case Level::Ok:
+            return createLogtypeString<Level::Ok>();
+    }
+    return "";
+}
 
-    return oss.str();
-#endif // COMPONENTS_IS_ENABLED_QT
+/**
+ * @brief getLevelLabel Получение метки уровня для заголовка записи (между моментом времени и аргументами)
+ * @param logType       Тип записи
+ * @param colored       С управляющими символами цвета
+ * @return              Строка вида " [ INFO ]  ", вычисленная при компиляции. Пустая для Level::Empty
+ */
+constexpr std::string_view getLevelLabel(Level logType, bool colored) {
+    switch (logType) {
+        case Level::Empty:
+            return {};
+        case Level::Debug:
+            return colored ? " [\033[35m DEBG \033[0m]  " : " [ DEBG ]  ";
+        case Level::Info:
+            return colored ? " [\033[37m INFO \033[0m]  " : " [ INFO ]  ";
+        case Level::Warning:
+            return colored ? " [\033[33m WARN \033[0m]  " : " [ WARN ]  ";
+        case Level::Error:
+            return colored ? " [\033[31m FAIL \033[0m]  " : " [ FAIL ]  ";
+        case Level::Ok:
+            return colored ? " [\033[32m  OK  \033[0m]  " : " [  OK  ]  ";
+    }
+    return {};
 }
 
 }
@@ -0,0 +1,355 @@
+#include "crashhandler.hpp"
+
+#include "instancebase.hpp"
+
+#ifdef COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <mutex>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define COMPLOG_PRIVATE_HAS_BACKTRACE
+#endif // has <execinfo.h>
+
+#include "timestamp.hpp"
+
+namespace Logger
+{
+
+// Сигналы аварийного завершения, перехватываемые обработчиком
+constexpr int CRASH_SIGNALS[] {SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+
+// Максимальное количество инстанций, выводящих отчёт о падении
+constexpr std::size_t MAX_CRASH_INSTANCES {16};
+
+// Максимальная глубина стека вызовов в отчёте
+constexpr int MAX_BACKTRACE_DEPTH {64};
+
+// Размер альтернативного стека обработчика (переполнение стека потока, установившего обработчик)
+constexpr std::size_t ALT_STACK_SIZE {64 * 1024};
+
+static std::atomic<InstanceBase*> s_crashInstances[MAX_CRASH_INSTANCES] {};
+static struct sigaction           s_previousActions[std::size(CRASH_SIGNALS)];
+static std::int64_t               s_utcOffset {0};
+static char                       s_altStack[ALT_STACK_SIZE];
+static std::mutex                 s_installMx;
+static bool                       s_isInstalled {false};
+
+/**
+ * @brief getSignalName Название сигнала аварийного завершения
+ */
+static std::string_view getSignalName(int signal)
+{
+    switch (signal) {
+        case SIGSEGV:
+            return "SIGSEGV";
+        case SIGABRT:
+            return "SIGABRT";
+        case SIGBUS:
+            return "SIGBUS";
+        case SIGFPE:
+            return "SIGFPE";
+    }
+    return "unknown";
+}
+
+CrashWriter::CrashWriter(int fd, std::int64_t utcOffset) :
+    m_fd {fd},
+    m_utcOffset {utcOffset}
+{
+
+}
+
+CrashWriter::~CrashWriter()
+{
+    flush();
+}
+
+void CrashWriter::append(const char *data, std::size_t size)
+{
+    while (size > 0) {
+        if (m_size == BUFFER_SIZE) {
+            flush();
+        }
+        const auto chunk = std::min(size, BUFFER_SIZE - m_size);
+        std::memcpy(m_buffer + m_size, data, chunk);
+        m_size += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void CrashWriter::appendNumber(std::uint64_t v, int base)
+{
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), v, base);
+    append(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void CrashWriter::appendTimestamp(std::chrono::system_clock::time_point time)
+{
+    char timestamp[TimestampFormatter::TIMESTAMP_SIZE];
+    append(timestamp, TimestampFormatter::formatAtOffset(time, m_utcOffset, timestamp));
+}
+
+void CrashWriter::appendSampleRate(std::uint32_t sampleRate)
+{
+    append(std::string_view("(sampled 1/"));
+    appendNumber(sampleRate);
+    append(std::string_view(") "));
+}
+
+void CrashWriter::appendRecord(const Record &record, std::chrono::system_clock::time_point time)
+{
+    if (record.level() != Level::Empty) {
+        appendTimestamp(time);
+    }
+    append(getLevelLabel(record.level(), false));
+    if (record.sampleRate() > 1) {
+        appendSampleRate(record.sampleRate());
+    }
+    record.visitArgs([this](const auto& v) {
+        appendArg(v);
+    });
+    append('\n');
+}
+
+void CrashWriter::flush()
+{
+    const char* data = m_buffer;
+    while (m_size > 0) {
+        const auto written = ::write(m_fd, data, m_size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            break;
+        }
+        data += written;
+        m_size -= static_cast<std::size_t>(written);
+    }
+    m_size = 0;
+}
+
+// Как TextBuffer::appendArg
+void CrashWriter::appendArg(bool v)
+{
+    append(v ? std::string_view("true ") : std::string_view("false "));
+}
+
+void CrashWriter::appendArg(char v)
+{
+    append(v);
+    append(' ');
+}
+
+void CrashWriter::appendArg(std::int64_t v)
+{
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), v);
+    append(digits, static_cast<std::size_t>(result.ptr - digits));
+    append(' ');
+}
+
+void CrashWriter::appendArg(std::uint64_t v)
+{
+    appendNumber(v);
+    append(' ');
+}
+
+void CrashWriter::appendArg(double v)
+{
+    char digits[32];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), v, std::chars_format::general, 6);
+    if (result.ec == std::errc()) {
+        append(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+    append(' ');
+}
+
+void CrashWriter::appendArg(std::string_view v)
+{
+    append(v);
+    append(' ');
+}
+
+void CrashWriter::appendArg(const void *v)
+{
+    const auto value = reinterpret_cast<std::uintptr_t>(v);
+    if (value == 0) {
+        append(std::string_view("0 "));
+        return;
+    }
+    append(std::string_view("0x"));
+    appendNumber(value, 16);
+    append(' ');
+}
+
+void CrashWriter::appendArg(FieldKey v)
+{
+    append(v.name);
+    append('=');
+}
+
+bool CrashHandler::addInstance(InstanceBase &instance)
+{
+    install();
+    for (auto& slot : s_crashInstances) {
+        if (slot.load(std::memory_order_relaxed) == &instance) {
+            return true;
+        }
+    }
+    for (auto& slot : s_crashInstances) {
+        InstanceBase* expected {nullptr};
+        if (slot.compare_exchange_strong(expected, &instance, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CrashHandler::removeInstance(InstanceBase &instance)
+{
+    for (auto& slot : s_crashInstances) {
+        InstanceBase* expected {&instance};
+        slot.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+}
+
+void CrashHandler::install()
+{
+    std::lock_guard<std::mutex> lock(s_installMx);
+    if (s_isInstalled) {
+        return;
+    }
+
+    // Всё, что может выделять память или брать блокировки, выполняется заранее:
+    // смещение часового пояса, загрузка libgcc для backtrace, опорная точка часов
+    const auto now = std::time(nullptr);
+    std::tm timeParts;
+    if (localtime_r(&now, &timeParts) != nullptr) {
+        s_utcOffset = timeParts.tm_gmtoff;
+    }
+#ifdef COMPLOG_PRIVATE_HAS_BACKTRACE
+    void* frame;
+    backtrace(&frame, 1);
+#endif // COMPLOG_PRIVATE_HAS_BACKTRACE
+    ClockCalibration().toSystemTime(Clock::now());
+
+    stack_t altStack {};
+    if (sigaltstack(nullptr, &altStack) == 0 && (altStack.ss_flags & SS_DISABLE)) {
+        altStack.ss_sp = s_altStack;
+        altStack.ss_size = sizeof(s_altStack);
+        altStack.ss_flags = 0;
+        sigaltstack(&altStack, nullptr);
+    }
+
+    // Без SA_RESETHAND: поток, упавший во время отчёта, тоже попадает в обработчик и ждёт его завершения.
+    // Сигналы падения заблокированы на время обработчика, поэтому выводящий отчёт поток в него не возвращается
+    struct sigaction action {};
+    action.sa_handler = &CrashHandler::handleSignal;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (const auto crashSignal : CRASH_SIGNALS) {
+        sigaddset(&action.sa_mask, crashSignal);
+    }
+    for (std::size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        sigaction(CRASH_SIGNALS[i], &action, &s_previousActions[i]);
+    }
+    s_isInstalled = true;
+}
+
+void CrashHandler::handleSignal(int signal)
+{
+    const int savedErrno = errno;
+
+    // Отчёт выводит первый упавший поток. Остальные ждут, пока он не повторит сигнал и не завершит процесс:
+    // повторённый ими сигнал прервал бы отчёт
+    if (s_isCrashing.exchange(true, std::memory_order_relaxed)) {
+        for (;;) {
+            pause();
+        }
+    }
+
+#ifdef COMPLOG_PRIVATE_HAS_BACKTRACE
+    void* frames[MAX_BACKTRACE_DEPTH];
+    const int framesCount = backtrace(frames, MAX_BACKTRACE_DEPTH);
+#endif // COMPLOG_PRIVATE_HAS_BACKTRACE
+
+    for (auto& slot : s_crashInstances) {
+        auto instance = slot.load(std::memory_order_acquire);
+        const char* path = instance != nullptr ? instance->getCrashLogfile() : nullptr;
+        if (path == nullptr) {
+            continue;
+        }
+        const int fd = ::open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            continue;
+        }
+        {
+            CrashWriter writer(fd, s_utcOffset);
+            instance->writeCrashReport(writer);
+
+            timespec now {};
+            clock_gettime(CLOCK_REALTIME, &now);
+            writer.appendTimestamp(std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec))));
+            writer.append(getLevelLabel(Level::Error, false));
+            writer.append(std::string_view("Fatal signal "));
+            writer.appendNumber(static_cast<std::uint64_t>(signal));
+            writer.append(std::string_view(" ("));
+            writer.append(getSignalName(signal));
+            writer.append(std::string_view("), backtrace:\n"));
+        }
+#ifdef COMPLOG_PRIVATE_HAS_BACKTRACE
+        backtrace_symbols_fd(frames, framesCount, fd);
+#endif // COMPLOG_PRIVATE_HAS_BACKTRACE
+        ::close(fd);
+    }
+
+    // Прежний обработчик (или действие по умолчанию) получает повторённый сигнал после возврата
+    for (std::size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        if (CRASH_SIGNALS[i] != signal) {
+            continue;
+        }
+        auto previous = s_previousActions[i];
+        if (!(previous.sa_flags & SA_SIGINFO) && previous.sa_handler == SIG_IGN) {
+            previous.sa_handler = SIG_DFL;
+        }
+        sigaction(signal, &previous, nullptr);
+    }
+    errno = savedErrno;
+    raise(signal);
+}
+
+}
+
+#else
+
+namespace Logger
+{
+
+bool CrashHandler::addInstance(InstanceBase &/*instance*/)
+{
+    return false;
+}
+
+void CrashHandler::removeInstance(InstanceBase &/*instance*/)
+{
+
+}
+
+}
+
+#endif // COMPLOG_PRIVATE_HAS_CRASH_HANDLER
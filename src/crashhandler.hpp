@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * @file crashhandler.hpp Файл с определением вывода отчёта о падении процесса из обработчика сигнала
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "record.hpp"
+
+namespace Logger
+{
+
+class InstanceBase;
+
+/**
+ * @brief The CrashWriter class Вывод текста в файловый дескриптор из обработчика сигнала
+ * @note  Только async-signal-safe операции: фиксированный буфер, std::to_chars и write(2),
+ *        память не выделяется. Записи выводятся в том же виде, что и в текстовом логфайле
+ */
+class CrashWriter
+{
+public:
+    /**
+     * @param fd        Открытый файловый дескриптор. Не закрывается
+     * @param utcOffset Смещение местного времени от UTC в секундах (для моментов записей)
+     */
+    CrashWriter(int fd, std::int64_t utcOffset);
+    ~CrashWriter();
+
+    CrashWriter(const CrashWriter&) = delete;
+    CrashWriter& operator =(const CrashWriter&) = delete;
+
+    void append(const char* data, std::size_t size);
+
+    void append(std::string_view text) {
+        append(text.data(), text.size());
+    }
+
+    void append(char ch) {
+        append(&ch, 1);
+    }
+
+    void appendNumber(std::uint64_t v, int base = 10);
+
+    /**
+     * @brief appendTimestamp   Добавить момент времени в формате логфайла (см. TimestampFormatter)
+     */
+    void appendTimestamp(std::chrono::system_clock::time_point time);
+
+    /**
+     * @brief appendSampleRate  Добавить метку выборочной записи "(sampled 1/N) "
+     */
+    void appendSampleRate(std::uint32_t sampleRate);
+
+    /**
+     * @brief appendRecord  Отформатировать и добавить запись, ещё не выведенную рабочим потоком
+     * @param record        Запись
+     * @param time          Момент записи в системном времени
+     */
+    void appendRecord(const Record& record, std::chrono::system_clock::time_point time);
+
+    /**
+     * @brief flush Записать буфер в файловый дескриптор
+     */
+    void flush();
+
+private:
+    static constexpr std::size_t BUFFER_SIZE {4096};
+
+    int          m_fd;
+    std::int64_t m_utcOffset;
+    std::size_t  m_size {0};
+    char         m_buffer[BUFFER_SIZE];
+
+    void appendArg(bool v);
+    void appendArg(char v);
+    void appendArg(std::int64_t v);
+    void appendArg(std::uint64_t v);
+    void appendArg(double v);
+    void appendArg(std::string_view v);
+    void appendArg(const void* v);
+    void appendArg(FieldKey v);
+};
+
+/**
+ * @brief The CrashHandler class Обработчик SIGSEGV, SIGABRT, SIGBUS и SIGFPE (см. InstanceBase::setCrashHandler)
+ * @note  Для каждой зарегистрированной инстанции дописывает в её логфайл записи, ещё не выведенные
+ *        приёмниками, строку с номером сигнала и стек вызовов (backtrace_symbols_fd), после чего
+ *        восстанавливает прежний обработчик и повторяет сигнал
+ */
+class CrashHandler
+{
+public:
+    /**
+     * @brief addInstance   Зарегистрировать инстанцию. При первом вызове устанавливает обработчики сигналов
+     * @return              false, если обработчик недоступен на платформе или инстанций слишком много
+     */
+    static bool addInstance(InstanceBase& instance);
+
+    /**
+     * @brief removeInstance    Исключить инстанцию. Вызывается до разрушения её приёмников
+     */
+    static void removeInstance(InstanceBase& instance);
+
+    /**
+     * @brief isCrashing    Обработчик выполняется: рабочие потоки прекращают извлекать записи из очереди,
+     *                      чтобы отчёт не разошёлся с ней
+     */
+    static bool isCrashing() {
+        return s_isCrashing.load(std::memory_order_relaxed);
+    }
+
+private:
+    static inline std::atomic<bool> s_isCrashing {false};
+
+    static void install();
+    static void handleSignal(int signal);
+};
+
+}
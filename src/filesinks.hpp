@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file filesinks.hpp Файл с определением приёмников текстового логфайла с другим способом записи
+ */
+
+#include <string>
+#include <utility>
+
+#include "sink.hpp"
+#include "mappedfilewriter.hpp"
+#include "asyncfilewriter.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The TextFileSink class Приёмник текстового логфайла: пакет записей выводится через Writer
+ *        одной операцией записи, строки совпадают с основным логфайлом инстанции
+ * @note  Writer - наследник FileWriterBase с методами write(data, size) и flush()
+ */
+template <typename Writer>
+class TextFileSink final : public Sink
+{
+public:
+    /**
+     * @param filePath      Путь файла. Ротация настраивается через getFilewriter()
+     * @param writerArgs    Параметры конструктора Writer
+     */
+    template <typename... WriterArgs>
+    explicit TextFileSink(const std::string& filePath, WriterArgs&&... writerArgs) :
+        m_fileWriter(std::forward<WriterArgs>(writerArgs)...)
+    {
+        m_fileWriter.setLogfile(filePath);
+    }
+
+    TextFileSink(const TextFileSink&) = delete;
+    TextFileSink& operator =(const TextFileSink&) = delete;
+
+    Writer& getFilewriter() {
+        return m_fileWriter;
+    }
+
+    void write(const FormattedRecord& record) override {
+        record.appendTo(m_buffer, false);
+    }
+
+    void flush() override {
+        if (!m_buffer.empty()) {
+            try {
+                m_fileWriter.write(m_buffer.data(), m_buffer.size());
+            } catch (...) {
+                m_buffer.clear();
+                throw;
+            }
+            m_buffer.clear();
+        }
+        m_fileWriter.flush();
+    }
+
+private:
+    Writer     m_fileWriter;
+    TextBuffer m_buffer; //! Пакет записей для вывода в файл
+};
+
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+/**
+ * @brief MappedFileSink Логфайл через отображение в память (MappedFileWriter)
+ * @note  Пропускная способность ниже, чем у основного логфайла (см. LoggerBenchmark.MappedFileWriter),
+ *        но записи попадают в страничный кэш сразу при копировании и сохраняются, даже если процесс
+ *        завершён SIGKILL (OOM) посреди пакета, когда обработчик падения не выполняется
+ */
+using MappedFileSink = TextFileSink<MappedFileWriter>;
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
+
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+/**
+ * @brief AsyncFileSink Логфайл с отправкой пакетов через io_uring (AsyncFileWriter)
+ * @note  На быстром локальном диске не быстрее основного логфайла (см. LoggerBenchmark.AsyncFileWriter).
+ *        Предназначен для медленных или сетевых дисков: поток приёмника не ждёт завершения записи
+ */
+using AsyncFileSink = TextFileSink<AsyncFileWriter>;
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
+
+}
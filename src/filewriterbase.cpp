@@ -1,14 +1,262 @@
 #include "filewriterbase.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <mutex>
 #include <filesystem>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace Logger
 {
 
+// Максимальный размер пути логфайла, доступного обработчику сигнала (с завершающим нулём)
+constexpr std::size_t SIGNAL_SAFE_PATH_SIZE {4096};
+
+/**
+ * @brief The FileRemover class Удаление файлов в фоновом потоке, чтобы не задерживать запись
+ */
+class FileRemover
+{
+public:
+    ~FileRemover() {
+        {
+            std::lock_guard lock(m_mx);
+            m_isWorking = false;
+        }
+        m_cv.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    void remove(std::filesystem::path path) {
+        {
+            std::lock_guard lock(m_mx);
+            m_paths.push_back(std::move(path));
+            if (!m_thread.joinable()) {
+                m_thread = std::thread(&FileRemover::work, this);
+            }
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    std::mutex m_mx;
+    std::condition_variable m_cv;
+    std::vector<std::filesystem::path> m_paths;
+    bool m_isWorking {true};
+    std::thread m_thread;
+
+    void work() {
+        std::vector<std::filesystem::path> paths;
+        std::unique_lock lock(m_mx);
+        while (true) {
+            m_cv.wait(lock, [this]() { return !m_paths.empty() || !m_isWorking; });
+            if (m_paths.empty()) {
+                return;
+            }
+            paths.swap(m_paths);
+
+            lock.unlock();
+            for (const auto& path : paths) {
+                std::error_code errCode;
+                std::filesystem::remove(path, errCode);
+            }
+            paths.clear();
+            lock.lock();
+        }
+    }
+};
+
+// Маска названия логфайла по createLogfileName(): 2026-12-31_23-59-59
+constexpr std::string_view LOGFILE_NAME_MASK {"0000-00-00_00-00-00"};
+
+/**
+ * @brief The RetainedFile struct Файл серии, учитываемый при ограничении хранимых файлов
+ */
+struct RetainedFile
+{
+    std::filesystem::path path;
+    std::uint64_t size;
+    bool isOwn;     //! Файл создан этим логгером, а не найден в директории
+};
+
+/**
+ * @brief parseSeriesName   Разобрать название файла логгера вида 2026-12-31_23-59-59[.N]<extension>
+ * @return                  Момент создания серии и номер файла в ней (для упорядочивания),
+ *                          std::nullopt для файлов, созданных не логгером
+ */
+static std::optional<std::tuple<std::string, std::size_t>> parseSeriesName(const std::string& name, const std::string& extension)
+{
+    if (name.size() < LOGFILE_NAME_MASK.size() + extension.size() ||
+        name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < LOGFILE_NAME_MASK.size(); ++i) {
+        const bool isDigit = std::isdigit(static_cast<unsigned char>(name[i])) != 0;
+        if (LOGFILE_NAME_MASK[i] == '0' ? !isDigit : name[i] != LOGFILE_NAME_MASK[i]) {
+            return std::nullopt;
+        }
+    }
+
+    // Необязательный номер файла серии: .N
+    const auto index = std::string_view(name).substr(LOGFILE_NAME_MASK.size(), name.size() - LOGFILE_NAME_MASK.size() - extension.size());
+    std::size_t seriesIndex {0};
+    if (!index.empty()) {
+        if (index.size() < 2 || index.front() != '.') {
+            return std::nullopt;
+        }
+        for (const auto ch : index.substr(1)) {
+            if (!std::isdigit(static_cast<unsigned char>(ch))) {
+                return std::nullopt;
+            }
+            seriesIndex = seriesIndex * 10 + static_cast<std::size_t>(ch - '0');
+        }
+    }
+    return std::make_tuple(name.substr(0, LOGFILE_NAME_MASK.size()), seriesIndex);
+}
+
 struct FileWriterBase::Impl
 {
     std::mutex writeMx;
+
+    RotationPolicy policy;
+    std::uint64_t currentSize {0};          //! Размер текущего файла
+    std::filesystem::path seriesPath;       //! Путь, заданный через setLogfile (первый файл серии)
+    std::size_t seriesIndex {0};            //! Номер текущего файла серии
+    std::deque<RetainedFile> retainedFiles; //! Закрытые файлы серии, от старых к новым
+    std::uint64_t retainedSize {0};         //! Суммарный размер закрытых файлов серии
+    FileRemover remover;
+
+    // Копии пути для обработчика сигнала: заполняется неактивная, затем она публикуется
+    char signalSafePaths[2][SIGNAL_SAFE_PATH_SIZE] {};
+    std::atomic<int> signalSafePathIndex {-1};
+
+    /**
+     * @brief publishSignalSafePath Обновить путь, доступный обработчику сигнала
+     */
+    void publishSignalSafePath(const std::string& path) {
+        if (path.size() >= SIGNAL_SAFE_PATH_SIZE) {
+            signalSafePathIndex.store(-1, std::memory_order_release);
+            return;
+        }
+        const int index = signalSafePathIndex.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+        std::memcpy(signalSafePaths[index], path.c_str(), path.size() + 1);
+        signalSafePathIndex.store(index, std::memory_order_release);
+    }
+
+    /**
+     * @brief scanRetainedFiles Учесть файлы логгера, уже существующие в директории логфайла
+     *                          (от прежних запусков процесса и других логгеров), от старых к новым.
+     *                          Выполняется только при RotationPolicy::retainPreviousRuns
+     * @param logfilePath       Путь открываемого логфайла, сам он не учитывается
+     */
+    void scanRetainedFiles(const std::filesystem::path& logfilePath) {
+        std::vector<std::filesystem::path> ownPaths;
+        for (const auto& file : retainedFiles) {
+            if (file.isOwn) {
+                ownPaths.push_back(file.path);
+            }
+        }
+        retainedFiles.clear();
+        retainedSize = 0;
+
+        const auto extension = logfilePath.extension().string();
+        std::vector<std::tuple<std::string, std::size_t, RetainedFile>> found;
+        std::error_code errCode;
+        for (std::filesystem::directory_iterator it(logfilePath.parent_path(), errCode), end; !errCode && it != end; it.increment(errCode)) {
+            if (it->path() == logfilePath || !it->is_regular_file(errCode)) {
+                continue;
+            }
+            const auto key = parseSeriesName(it->path().filename().string(), extension);
+            if (!key) {
+                continue;
+            }
+            const auto size = it->file_size(errCode);
+            const bool isOwn = std::find(ownPaths.begin(), ownPaths.end(), it->path()) != ownPaths.end();
+            found.emplace_back(std::get<0>(*key), std::get<1>(*key), RetainedFile {it->path(), errCode ? 0 : size, isOwn});
+        }
+
+        std::sort(found.begin(), found.end(), [](const auto& l, const auto& r) {
+            return std::tie(std::get<0>(l), std::get<1>(l)) < std::tie(std::get<0>(r), std::get<1>(r));
+        });
+        for (auto& file : found) {
+            retainedSize += std::get<2>(file).size;
+            retainedFiles.push_back(std::move(std::get<2>(file)));
+        }
+    }
+
+    /**
+     * @brief forgetForeignFiles    Перестать учитывать файлы, созданные не этим логгером
+     */
+    void forgetForeignFiles() {
+        const auto foreign = std::remove_if(retainedFiles.begin(), retainedFiles.end(), [](const RetainedFile& file) {
+            return !file.isOwn;
+        });
+        for (auto it = foreign; it != retainedFiles.end(); ++it) {
+            retainedSize -= it->size;
+        }
+        retainedFiles.erase(foreign, retainedFiles.end());
+    }
+
+    /**
+     * @brief retainPrevious    Перенести закрываемый файл в хранимые при переходе к файлу той же серии
+     *                          (ротация по времени). При смене директории учитываются только
+     *                          существующие файлы логгера, если это разрешено политикой
+     */
+    void retainPrevious(const std::filesystem::path& previousPath, const std::filesystem::path& logfilePath) {
+        const bool isSameSeries = !previousPath.empty() &&
+                                  previousPath.parent_path() == logfilePath.parent_path() &&
+                                  previousPath.extension() == logfilePath.extension();
+        if (!isSameSeries) {
+            retainedFiles.clear();
+            retainedSize = 0;
+            if (policy.retainPreviousRuns) {
+                scanRetainedFiles(logfilePath);
+            }
+            return;
+        }
+        // Файл открывается при первой записи: пустая серия могла не создать его
+        std::error_code errCode;
+        if (previousPath != logfilePath && std::filesystem::exists(previousPath, errCode)) {
+            retainedFiles.push_back({previousPath, currentSize, true});
+            retainedSize += currentSize;
+        }
+        auto reopened = std::find_if(retainedFiles.begin(), retainedFiles.end(), [&](const RetainedFile& file) {
+            return file.path == logfilePath;
+        });
+        if (reopened != retainedFiles.end()) {
+            retainedSize -= reopened->size;
+            retainedFiles.erase(reopened);
+        }
+    }
+
+    /**
+     * @brief enforceRetention  Удалить старые файлы сверх ограничений политики
+     */
+    void enforceRetention() {
+        auto isExceeded = [this]() {
+            if (retainedFiles.empty()) {
+                return false;
+            }
+            const bool tooMany = policy.maxFiles != 0 && retainedFiles.size() + 1 > policy.maxFiles;
+            const bool tooLarge = policy.maxTotalSize != 0 && retainedSize + currentSize > policy.maxTotalSize;
+            return tooMany || tooLarge;
+        };
+
+        while (isExceeded()) {
+            retainedSize -= retainedFiles.front().size;
+            remover.remove(std::move(retainedFiles.front().path));
+            retainedFiles.pop_front();
+        }
+    }
 };
 
 FileWriterBase::FileWriterBase() :
@@ -24,12 +272,21 @@ FileWriterBase::~FileWriterBase()
 
 void FileWriterBase::setLogfile(const std::string &filePath)
 {
+    const auto previousPath = m_logfilePath;
     m_logfilePath = std::filesystem::absolute(filePath);
+
+    // Хранимые файлы сохраняются при ротации по времени, файлы прежних запусков учитываются по политике
+    d->retainPrevious(previousPath, m_logfilePath);
+    d->publishSignalSafePath(m_logfilePath);
+    d->seriesPath = m_logfilePath;
+    d->seriesIndex = 0;
+    d->currentSize = 0;
+    d->enforceRetention();
 }
 
 void FileWriterBase::setLogfile(const std::string_view &filePath)
 {
-    m_logfilePath = std::filesystem::absolute(std::string(filePath));
+    setLogfile(std::string(filePath));
 }
 
 std::string_view FileWriterBase::getLogfilePath() const
@@ -40,6 +297,32 @@ std::string_view FileWriterBase::getLogfilePath() const
     return m_logfilePath;
 }
 
+const char *FileWriterBase::getSignalSafePath() const
+{
+    const int index = d->signalSafePathIndex.load(std::memory_order_acquire);
+    return index < 0 ? nullptr : d->signalSafePaths[index];
+}
+
+void FileWriterBase::setRotation(const RotationPolicy &policy)
+{
+    lockFile();
+    const bool wasRetainingPreviousRuns = d->policy.retainPreviousRuns;
+    d->policy = policy;
+    if (policy.retainPreviousRuns && !wasRetainingPreviousRuns && hasLogfile()) {
+        d->scanRetainedFiles(m_logfilePath);
+    } else if (!policy.retainPreviousRuns && wasRetainingPreviousRuns) {
+        d->forgetForeignFiles();
+    }
+    d->enforceRetention();
+    unlockFile();
+}
+
+RotationPolicy FileWriterBase::getRotation() const
+{
+    std::lock_guard lock(d->writeMx);
+    return d->policy;
+}
+
 void FileWriterBase::lockFile()
 {
     d->writeMx.lock();
@@ -50,4 +333,42 @@ void FileWriterBase::unlockFile()
     d->writeMx.unlock();
 }
 
+bool FileWriterBase::hasLogfile() const
+{
+    return !m_logfilePath.empty();
+}
+
+bool FileWriterBase::isRotationNeeded(std::uint64_t size) const
+{
+    return d->policy.maxFileSize != 0 && d->currentSize != 0 &&
+           d->currentSize + size > d->policy.maxFileSize;
+}
+
+void FileWriterBase::rotateLogfile()
+{
+    d->retainedFiles.push_back({m_logfilePath, d->currentSize, true});
+    d->retainedSize += d->currentSize;
+
+    // 2026-12-31_23-59-59.log -> 2026-12-31_23-59-59.1.log
+    std::filesystem::path nextPath = d->seriesPath;
+    nextPath.replace_extension(std::to_string(++d->seriesIndex) + d->seriesPath.extension().string());
+    m_logfilePath = nextPath.string();
+    d->publishSignalSafePath(m_logfilePath);
+    d->currentSize = 0;
+
+    d->enforceRetention();
+}
+
+void FileWriterBase::countOpenedSize()
+{
+    std::error_code errCode;
+    const auto size = std::filesystem::file_size(m_logfilePath, errCode);
+    d->currentSize = errCode ? 0 : size;
+}
+
+void FileWriterBase::countWrittenSize(std::uint64_t size)
+{
+    d->currentSize += size;
+}
+
 }
@@ -1,11 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 
 namespace Logger
 {
 
+/**
+ * @brief The RotationPolicy struct Ограничения размера логфайлов. Нулевое значение снимает ограничение
+ */
+struct RotationPolicy
+{
+    std::uint64_t maxFileSize {0};  //! Размер файла, после которого запись переходит в новый файл
+    std::size_t   maxFiles {0};     //! Число хранимых файлов, включая текущий
+    std::uint64_t maxTotalSize {0}; //! Суммарный размер хранимых файлов, включая текущий
+    bool retainPreviousRuns {false};//! Учитывать (и удалять) файлы логгера прежних запусков и других
+                                    //! логгеров в директории логфайла, а не только созданные этим логгером
+};
+
 /**
  * @brief The FileWriterBase class  Базовый класс для записывающей в файл части логгера
  */
@@ -19,6 +32,23 @@ public:
     virtual void setLogfile(const std::string_view& filePath);
     std::string_view getLogfilePath() const;
 
+    /**
+     * @brief getSignalSafePath Путь текущего логфайла для обработчика сигнала (без блокировок и выделения памяти)
+     * @return                  nullptr, если путь не задан или слишком длинный
+     */
+    const char* getSignalSafePath() const;
+
+    /**
+     * @brief setRotation   Задать ротацию логфайлов по размеру
+     * @param policy        Ограничения. По умолчанию ротация отключена
+     * @note                Файлы серии получают имена вида 2026-12-31_23-59-59.1.log.
+     *                      Ограничения учитывают файлы, созданные этим логгером, в том числе при ротации
+     *                      по времени. Файлы прежних запусков и других логгеров той же директории
+     *                      учитываются только при retainPreviousRuns. Старые файлы удаляются в фоновом потоке
+     */
+    void setRotation(const RotationPolicy& policy);
+    RotationPolicy getRotation() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> d;
@@ -27,6 +57,38 @@ private:
 protected:
     void lockFile();
     void unlockFile();
+
+    /**
+     * @brief hasLogfile    Задан ли путь логфайла
+     * @note                Проверяется перед открытием, чтобы getLogfilePath() не бросал исключение под lockFile()
+     */
+    bool hasLogfile() const;
+
+    /**
+     * @brief isRotationNeeded  Проверка необходимости перейти в новый файл перед записью
+     * @param size              Размер данных, которые будут записаны
+     * @note                    Вызывается под lockFile()
+     */
+    bool isRotationNeeded(std::uint64_t size) const;
+
+    /**
+     * @brief rotateLogfile Перейти к следующему файлу серии и запланировать удаление старых.
+     *                      Текущий файл должен быть закрыт, новый открывается наследником
+     * @note                Вызывается под lockFile()
+     */
+    void rotateLogfile();
+
+    /**
+     * @brief countOpenedSize   Учесть размер уже существующего файла после открытия
+     * @note                    Вызывается под lockFile()
+     */
+    void countOpenedSize();
+
+    /**
+     * @brief countWrittenSize  Учесть записанные данные
+     * @note                    Вызывается под lockFile()
+     */
+    void countWrittenSize(std::uint64_t size);
 };
 
 }
@@ -1,91 +1,793 @@
 #include "instancebase.hpp"
 
+#include "mpscring.hpp"
+#include "workerpool.hpp"
+
+#include <algorithm>
 #include <condition_variable>
-#include <functional>
-#include <deque>
 #include <mutex>
 #include <thread>
 #include <atomic>
-#include <future>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <filesystem>
 
 namespace Logger {
 
-struct InstanceBase::Impl {
+// Ёмкость очереди записей
+constexpr std::size_t RECORD_QUEUE_CAPACITY {4096};
+
+// Количество холостых проверок очереди перед засыпанием рабочего потока
+constexpr int WORKER_SPIN_COUNT {256};
+
+// Максимальный размер пакета записей по умолчанию
+constexpr std::size_t DEFAULT_MAX_BATCH_SIZE {1024};
+
+// Общий пул рабочих потоков для создаваемых инстанций (см. setSharedWorkers)
+static std::mutex s_sharedPoolMx;
+static std::shared_ptr<WorkerPool> s_sharedPool;
+static std::shared_ptr<WorkerPool> s_sharedSinkPool; // Один поток консоли инстанций общего пула
+
+// Версии правил setSiteLevel уникальны среди всех инстанций: место вызова кэширует решение только одной из них
+static std::atomic<std::uint64_t> s_siteRulesVersion {0};
+
+struct InstanceBase::Impl final : WorkerPool::Task {
+    InstanceBase*           owner {nullptr};
     std::atomic<bool>       isWorking {false};
-    std::future<void>       threadFut;
-    std::deque<task_t>      taskDeq;
+    std::thread             workerThread;      // Свой рабочий поток (без общего пула), присоединяется в stopWorker
+    std::shared_ptr<WorkerPool> pool;         // Задан, если вывод выполняет общий пул, а не свой поток
+    std::shared_ptr<WorkerPool> sinkPool;     // Общий поток консоли, задан вместе с pool
+    std::atomic<bool>       isPoolAttached {false};
+    MpscRing<Record>        recordRing {RECORD_QUEUE_CAPACITY};
+
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<bool>       isParked {false}; // Рабочий поток спит на notifyCV
     std::condition_variable notifyCV;
     std::mutex              notifyMx;
     std::mutex              outputMx; // Just for printing in right order
+
+    // Ожидание вывода записей (flush)
+    std::atomic<std::size_t> flushedCount {0};  // Количество извлечённых из очереди и выведенных записей
+    std::atomic<int>         flushWaiters {0};
+    std::atomic<bool>        isWorkerDone {false};  // Рабочий поток завершился (в том числе из-за исключения)
+    std::condition_variable  flushCV;
+    std::mutex               flushMx;
+
+    std::atomic<std::size_t>  maxBatchSize {DEFAULT_MAX_BATCH_SIZE};
+    std::atomic<std::int64_t> maxBatchDelayUs {0};
+
+    // Ожидание места в очереди производителями (OverflowPolicy::Block, KeepWarnings)
+    std::atomic<int>         blockedProducers {0};
+    std::condition_variable  spaceCV;
+    std::mutex               spaceMx;
+
+    std::atomic<std::size_t>    maxRecords {RECORD_QUEUE_CAPACITY};
+    std::atomic<std::size_t>    maxBytes {0};
+    std::atomic<OverflowPolicy> overflowPolicy {OverflowPolicy::Block};
+
+    // Места вызова со свёрнутыми, но ещё не выведенными повторами (см. submitRepeats)
+    std::mutex               repeatsMx;
+    std::vector<const CallSite*> repeatedSites;
+
+    alignas(CACHE_LINE_SIZE)
+    std::atomic<std::size_t>   queuedBytes {0};              // Суммарный размер аргументов записей в очереди
+    std::atomic<std::uint64_t> droppedTotal {0};
+    std::atomic<std::uint64_t> droppedCounts[LEVELS_COUNT] {};
+    std::uint64_t              reportedTotal {0};            // Уже выведенные в сводку (рабочий поток)
+    std::uint64_t              reportedCounts[LEVELS_COUNT] {};
+
+    /**
+     * @brief The SiteRule struct Правило setSiteLevel
+     */
+    struct SiteRule {
+        std::string   file;
+        unsigned      line;
+        std::uint64_t severity;
+    };
+    std::mutex            siteRulesMx;
+    std::vector<SiteRule> siteRules;
+
+    /**
+     * @brief isOverLimit   Проверка ограничений очереди перед добавлением записи
+     */
+    bool isOverLimit(std::size_t bytes) const {
+        if (recordRing.size() >= maxRecords.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        const auto bytesLimit = maxBytes.load(std::memory_order_relaxed);
+        return bytesLimit != 0 && queuedBytes.load(std::memory_order_relaxed) + bytes > bytesLimit;
+    }
+
+    /**
+     * @brief isOldestDropped Проверка, что извлечённую запись нужно отбросить (OverflowPolicy::DropOldest)
+     */
+    bool isOldestDropped() const {
+        if (overflowPolicy.load(std::memory_order_relaxed) != OverflowPolicy::DropOldest) {
+            return false;
+        }
+        const auto bytesLimit = maxBytes.load(std::memory_order_relaxed);
+        return recordRing.size() >= maxRecords.load(std::memory_order_relaxed) ||
+               (bytesLimit != 0 && queuedBytes.load(std::memory_order_relaxed) >= bytesLimit);
+    }
+
+    /**
+     * @brief publishFlushed Сообщить ожидающим flush() о выводе записей. Вызывается после flushOutput()
+     */
+    void publishFlushed() {
+        flushedCount.store(recordRing.dequeuedCount(), std::memory_order_seq_cst);
+        if (flushWaiters.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(flushMx);
+            flushCV.notify_all();
+        }
+        notifySpace();
+    }
+
+    /**
+     * @brief notifySpace Разбудить производителей, ожидающих места в очереди
+     */
+    void notifySpace() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (blockedProducers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(spaceMx);
+            spaceCV.notify_all();
+        }
+    }
+
+    /**
+     * @brief waitSpace Дождаться места в очереди или остановки рабочего потока
+     * @param hasSpace  Проверка наличия места
+     * @note            Производитель спит, пока рабочий поток не выведет очередной пакет (см. publishFlushed)
+     */
+    template <typename F>
+    void waitSpace(F&& hasSpace) {
+        blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeWorker();
+        {
+            std::unique_lock<std::mutex> lock(spaceMx);
+            spaceCV.wait(lock, [this, &hasSpace]() {
+                return hasSpace() || !isWorking.load(std::memory_order_acquire);
+            });
+        }
+        blockedProducers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief waitFlushed   Дождаться вывода записей до позиции target
+     * @param deadline      Крайний момент ожидания (std::nullopt - без ограничения)
+     */
+    bool waitFlushed(std::size_t target, std::optional<std::chrono::steady_clock::time_point> deadline) {
+        auto isFlushed = [this, target]() {
+            return flushedCount.load(std::memory_order_seq_cst) >= target ||
+                   isWorkerDone.load(std::memory_order_acquire);
+        };
+
+        flushWaiters.fetch_add(1, std::memory_order_seq_cst);
+        wakeWorker();
+        bool result;
+        {
+            std::unique_lock<std::mutex> lock(flushMx);
+            if (deadline) {
+                result = flushCV.wait_until(lock, *deadline, isFlushed);
+            } else {
+                flushCV.wait(lock, isFlushed);
+                result = true;
+            }
+        }
+        flushWaiters.fetch_sub(1, std::memory_order_seq_cst);
+        return result && flushedCount.load(std::memory_order_seq_cst) >= target;
+    }
+
+    /**
+     * @brief stopWorker Остановить рабочий поток и дождаться его завершения (без активного ожидания)
+     * @return           false, если поток уже остановлен
+     */
+    bool stopWorker() {
+        if (pool) {
+            if (!isPoolAttached.exchange(false, std::memory_order_acq_rel)) {
+                return false;
+            }
+            isWorking.store(false, std::memory_order_release);
+            pool->detach(*this);
+            notifyWorkerDone();
+            return true;
+        }
+        if (!workerThread.joinable()) {
+            return false;
+        }
+        isWorking.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(notifyMx);
+            isParked.store(false, std::memory_order_seq_cst);
+            notifyCV.notify_one();
+        }
+        workerThread.join();
+        return true;
+    }
+
+    bool hasWorker() const {
+        return workerThread.joinable() || isPoolAttached.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief notifyWorkerDone Вывод очереди завершён (в том числе из-за исключения): ожидающие flush() не должны зависнуть
+     */
+    void notifyWorkerDone() {
+        isWorking.store(false, std::memory_order_release);
+        isWorkerDone.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(flushMx);
+            flushCV.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(spaceMx);
+        spaceCV.notify_all();
+    }
+
+    /**
+     * @brief writeBatch    Вывести пакет накопившихся записей (не более maxBatchSize) одним сбросом буферов
+     * @param maxBatchDelay Максимальное время ожидания новых записей для заполнения пакета
+     */
+    void writeBatch(std::chrono::microseconds maxBatchDelay) {
+        const auto maxBatchSize = this->maxBatchSize.load(std::memory_order_relaxed);
+        const auto batchBegin = std::chrono::steady_clock::now();
+        std::size_t batchSize {0};
+        Record nextRecord;
+
+        std::unique_lock<std::mutex> lockg(outputMx);
+        for (;;) {
+            // При остановке (shutdown) пакет прерывается, остаток обрабатывает вызывающий поток
+            // При падении очередь не разбирается: её выводит обработчик сигнала
+            while (batchSize < maxBatchSize && isWorking.load(std::memory_order_relaxed) &&
+                   !CrashHandler::isCrashing() && recordRing.tryPop(nextRecord)) {
+                queuedBytes.fetch_sub(nextRecord.payloadSize(), std::memory_order_relaxed);
+                if (isOldestDropped()) {
+                    countDropped(nextRecord.level());
+                } else {
+                    owner->writeRecord(nextRecord);
+                }
+                nextRecord.clear();
+                ++batchSize;
+            }
+
+            if (batchSize >= maxBatchSize || maxBatchDelay.count() <= 0 ||
+                !isWorking.load(std::memory_order_acquire) ||
+                std::chrono::steady_clock::now() - batchBegin >= maxBatchDelay) {
+                break;
+            }
+
+            // Ожидание новых записей для заполнения пакета
+            lockg.unlock();
+            std::this_thread::yield();
+            lockg.lock();
+        }
+        if (takeDroppedSummary(nextRecord, false)) {
+            owner->writeRecord(nextRecord);
+            nextRecord.clear();
+        }
+        owner->flushOutput();
+        lockg.unlock();
+        publishFlushed();
+    }
+
+    /**
+     * @brief runSlice Один пакет в потоке общего пула
+     */
+    void runSlice() override {
+        if (!isWorking.load(std::memory_order_acquire)) {
+            return;
+        }
+        try {
+            writeBatch({});
+        } catch (...) {
+            // Как и для своего потока: после исключения инстанция выводит записи синхронно
+            notifyWorkerDone();
+        }
+    }
+
+    bool hasPendingWork() const override {
+        return isWorking.load(std::memory_order_acquire) && !recordRing.empty();
+    }
+
+    void countDropped(Level level) {
+        droppedCounts[static_cast<std::size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+        droppedTotal.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief takeDroppedSummary    Сводка отброшенных записей с момента предыдущей сводки
+     * @param force                 Не ждать освобождения очереди
+     * @return                      false, если выводить нечего или очередь ещё заполнена
+     */
+    bool takeDroppedSummary(Record& summary, bool force) {
+        const auto total = droppedTotal.load(std::memory_order_relaxed);
+        if (total == reportedTotal) {
+            return false;
+        }
+        // Давление спало: очередь заполнена не более чем наполовину
+        if (!force && recordRing.size() > maxRecords.load(std::memory_order_relaxed) / 2) {
+            return false;
+        }
+
+        std::string levels;
+        for (std::size_t i = 0; i < LEVELS_COUNT; ++i) {
+            const auto count = droppedCounts[i].load(std::memory_order_relaxed);
+            if (count != reportedCounts[i]) {
+                levels += std::string(levels.empty() ? "" : ", ") + std::string(getLevelName(static_cast<Level>(i))) + ": " +
+                          std::to_string(count - reportedCounts[i]);
+                reportedCounts[i] = count;
+            }
+        }
+        summary.assign(Level::Warning, "Log queue overflow: dropped", total - reportedTotal, "records (" + levels + ")");
+        reportedTotal = total;
+        return true;
+    }
+
+    /**
+     * @brief writeStopped  Вывести запись в вызывающем потоке после остановки рабочего потока
+     * @note                Асинхронный вызов не бросает исключений: запись, которую не удалось вывести,
+     *                      считается отброшенной и попадает в сводку после следующей выведенной записи
+     */
+    void writeStopped(const Record& record) {
+        try {
+            owner->addRecordSync(record);
+        } catch (...) {
+            countDropped(record.level());
+            return;
+        }
+
+        Record summary;
+        bool hasSummary;
+        {
+            std::lock_guard<std::mutex> lock(outputMx);
+            hasSummary = takeDroppedSummary(summary, true);
+        }
+        try {
+            if (hasSummary) {
+                owner->addRecordSync(summary);
+            }
+        } catch (...) {
+            // Вывод снова не работает: сводка не повторяется
+        }
+    }
+
+    /**
+     * @brief drainStopped  Вывести записи, оставшиеся в очереди после остановки рабочего потока
+     *                      (добавленные одновременно с shutdown или после ошибки вывода)
+     */
+    void drainStopped() {
+        Record record;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(outputMx);
+                if (!recordRing.tryPop(record)) {
+                    break;
+                }
+                queuedBytes.fetch_sub(record.payloadSize(), std::memory_order_relaxed);
+            }
+            writeStopped(record);
+            record.clear();
+        }
+        publishFlushed();
+    }
+
+    /**
+     * @brief wakeWorker Разбудить рабочий поток, если он спит
+     * @note             Начинается с полного барьера: парного с parkWorker и с закрытием очереди при остановке
+     */
+    void wakeWorker() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pool) {
+            pool->schedule(*this);
+            return;
+        }
+        if (isParked.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(notifyMx);
+            isParked.store(false, std::memory_order_seq_cst);
+            notifyCV.notify_one();
+        }
+    }
+
+    /**
+     * @brief parkWorker Усыпить рабочий поток до появления задач
+     */
+    void parkWorker() {
+        std::unique_lock<std::mutex> lock(notifyMx);
+        isParked.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (recordRing.empty() && isWorking.load(std::memory_order_acquire)) {
+            notifyCV.wait(lock, [this]() {
+                return !isParked.load(std::memory_order_seq_cst) ||
+                       !isWorking.load(std::memory_order_acquire);
+            });
+        }
+        isParked.store(false, std::memory_order_seq_cst);
+    }
 };
 
 InstanceBase::InstanceBase() :
     d {new Impl}
 {
+    d->owner = this;
     d->isWorking.store(true, std::memory_order_release);
-    std::packaged_task<void()> task([this]() {
-        task_t nextTask;
-
-        while (d->isWorking.load(std::memory_order_acquire)) {
-            std::unique_lock<std::mutex> lock(d->notifyMx);
-            while (!d->taskDeq.empty()) {
-                nextTask = d->taskDeq.front();
-                d->taskDeq.pop_front();
-                lock.unlock();
-
-                {
-                    std::lock_guard<std::mutex> lockg(d->outputMx);
-                    nextTask();
+    {
+        std::lock_guard<std::mutex> lock(s_sharedPoolMx);
+        d->pool = s_sharedPool;
+        d->sinkPool = s_sharedSinkPool;
+    }
+    if (d->pool) {
+        d->isPoolAttached.store(true, std::memory_order_release);
+        return;
+    }
+
+    // Поток присоединяется при остановке (stopWorker): после разрушения инстанции он не существует
+    d->workerThread = std::thread([this]() {
+        // Ожидающие flush() не должны зависнуть, если поток завершится из-за исключения
+        struct ExitNotifier {
+            Impl* d;
+            ~ExitNotifier() {
+                d->notifyWorkerDone();
+            }
+        } exitNotifier {d.get()};
+
+        int spinCount {0};
+
+        try {
+            while (d->isWorking.load(std::memory_order_acquire)) {
+                if (d->recordRing.empty()) {
+                    if (spinCount < WORKER_SPIN_COUNT) {
+                        ++spinCount;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    spinCount = 0;
+                    d->parkWorker();
+                    continue;
                 }
+                spinCount = 0;
 
-                lock.lock();
+                d->writeBatch(std::chrono::microseconds(d->maxBatchDelayUs.load(std::memory_order_relaxed)));
             }
-            d->notifyCV.wait(lock);
+        } catch (...) {
+            // Исключение из writeRecord/flushOutput завершает рабочий поток,
+            // дальнейшие записи выводятся синхронно (см. addRecord)
         }
     });
-    d->threadFut = task.get_future();
-    std::thread(std::move(task)).detach();
 }
 
 InstanceBase::~InstanceBase()
 {
-    if (d->threadFut.valid()) {
+    CrashHandler::removeInstance(*this);
+    if (d->hasWorker()) {
         deinit();
     }
 }
 
+bool InstanceBase::setCrashHandler(bool isEnabled)
+{
+    if (!isEnabled) {
+        CrashHandler::removeInstance(*this);
+        return true;
+    }
+    return CrashHandler::addInstance(*this);
+}
+
+void InstanceBase::writeCrashReport(CrashWriter &writer)
+{
+#ifdef COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+    writeCrashRecords(writer);
+    ClockCalibration clockCalibration;
+    d->recordRing.visitReady([&writer, &clockCalibration](const Record& record) {
+        writer.appendRecord(record, clockCalibration.toSystemTime(record.ticks()));
+    });
+#endif // COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+}
+
+void InstanceBase::setSharedWorkers(std::size_t threadsCount)
+{
+    auto pool = threadsCount > 0 ? std::make_shared<WorkerPool>(threadsCount) : nullptr;
+    auto sinkPool = threadsCount > 0 ? std::make_shared<WorkerPool>(1) : nullptr;
+    std::lock_guard<std::mutex> lock(s_sharedPoolMx);
+    // Прежний пул остаётся у созданных с ним инстанций до их удаления
+    s_sharedPool = std::move(pool);
+    s_sharedSinkPool = std::move(sinkPool);
+}
+
+void InstanceBase::setRateLimit(double recordsPerSecond, std::size_t burst)
+{
+    if (recordsPerSecond <= 0) {
+        m_rateIntervalTicks.store(0, std::memory_order_relaxed);
+        return;
+    }
+    const double ticksPerSecond = 1e9 / Clock::nanosecondsPerTick();
+    const auto interval = std::max<std::uint64_t>(static_cast<std::uint64_t>(ticksPerSecond / recordsPerSecond), 1);
+    m_rateToleranceTicks.store((std::max<std::size_t>(burst, 1) - 1) * interval, std::memory_order_relaxed);
+    m_rateIntervalTicks.store(interval, std::memory_order_relaxed);
+}
+
+void InstanceBase::setSampling(Level level, std::uint32_t oneIn)
+{
+    m_sampleRates[static_cast<std::size_t>(level)].store(std::max<std::uint32_t>(oneIn, 1), std::memory_order_relaxed);
+}
+
+void InstanceBase::setSiteLevel(std::string_view file, unsigned line, Level level)
+{
+    std::lock_guard<std::mutex> lock(d->siteRulesMx);
+    const auto severity = static_cast<std::uint64_t>(getLevelSeverity(level));
+    auto rule = std::find_if(d->siteRules.begin(), d->siteRules.end(), [file, line](const Impl::SiteRule& v) {
+        return v.file == file && v.line == line;
+    });
+    if (rule != d->siteRules.end()) {
+        rule->severity = severity;
+    } else {
+        d->siteRules.push_back({std::string(file), line, severity});
+    }
+    m_siteRulesVersion.store(s_siteRulesVersion.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void InstanceBase::clearSiteLevels()
+{
+    std::lock_guard<std::mutex> lock(d->siteRulesMx);
+    d->siteRules.clear();
+    m_siteRulesVersion.store(0, std::memory_order_release);
+}
+
+std::uint64_t InstanceBase::updateSiteSeverity(const CallSite &site) const
+{
+    std::lock_guard<std::mutex> lock(d->siteRulesMx);
+    const std::string_view file(site.file);
+    std::uint64_t severity {NO_SITE_RULE};
+    for (const auto& rule : d->siteRules) {
+        if (!file.ends_with(rule.file)) {
+            continue;
+        }
+        if (rule.line == site.line) {
+            severity = rule.severity;
+            break;
+        }
+        if (rule.line == 0) {
+            severity = rule.severity;
+        }
+    }
+
+    // Версия читается под блокировкой вместе с правилами, по которым вычислен порог
+    const auto version = m_siteRulesVersion.load(std::memory_order_relaxed);
+    site.state.filterCache.store((version << 8) | severity, std::memory_order_relaxed);
+    return severity;
+}
+
+void InstanceBase::setDeduplication(std::chrono::milliseconds window)
+{
+    const double ticksPerMs = 1e6 / Clock::nanosecondsPerTick();
+    m_dedupWindowTicks.store(window.count() > 0 ? static_cast<std::uint64_t>(window.count() * ticksPerMs) : 0,
+                             std::memory_order_relaxed);
+}
+
+bool InstanceBase::isRepeated(const CallSite &site, const Record &record, std::uint64_t window, std::uint64_t &repeated)
+{
+    auto& state = site.state;
+    // FNV-1a по уровню и сериализованным аргументам. 0 зарезервирован под "записей ещё не было"
+    std::uint64_t hash {14695981039346656037ull};
+    auto mix = [&hash](std::byte v) {
+        hash = (hash ^ static_cast<std::uint64_t>(v)) * 1099511628211ull;
+    };
+    mix(static_cast<std::byte>(record.level()));
+    for (std::size_t i = 0; i < record.payloadSize(); ++i) {
+        mix(record.payload()[i]);
+    }
+    hash |= 1;
+
+    const auto previous = state.lastHash.exchange(hash, std::memory_order_relaxed);
+    if (previous == hash && record.ticks() - state.lastWrittenTicks.load(std::memory_order_relaxed) < window) {
+        // Первый повтор серии: место вызова запоминается, чтобы вывести повторы, если записей больше не будет
+        if (state.repeatedCount.fetch_add(1, std::memory_order_relaxed) == 0) {
+            std::lock_guard<std::mutex> lock(d->repeatsMx);
+            if (std::find(d->repeatedSites.begin(), d->repeatedSites.end(), &site) == d->repeatedSites.end()) {
+                d->repeatedSites.push_back(&site);
+            }
+        }
+        return true;
+    }
+    repeated = state.repeatedCount.exchange(0, std::memory_order_relaxed);
+    state.lastWrittenTicks.store(record.ticks(), std::memory_order_relaxed);
+    return false;
+}
+
+void InstanceBase::submitRepeats()
+{
+    std::vector<const CallSite*> sites;
+    {
+        std::lock_guard<std::mutex> lock(d->repeatsMx);
+        sites.swap(d->repeatedSites);
+    }
+    for (auto site : sites) {
+        // Повторы, уже выведенные перед следующей записью места вызова, не повторяются
+        if (const auto repeated = site->state.repeatedCount.exchange(0, std::memory_order_relaxed)) {
+            Record note;
+            note.assign(*site, "Last message repeated", repeated, "times");
+            addRecord(std::move(note));
+        }
+    }
+}
+
+void InstanceBase::setBatching(std::size_t maxBatchSize, std::chrono::microseconds maxDelay)
+{
+    d->maxBatchSize.store(std::max<std::size_t>(maxBatchSize, 1), std::memory_order_relaxed);
+    d->maxBatchDelayUs.store(maxDelay.count(), std::memory_order_relaxed);
+}
+
+void InstanceBase::setQueueLimits(std::size_t maxRecords, std::size_t maxBytes)
+{
+    const auto capacity = d->recordRing.capacity();
+    d->maxRecords.store(maxRecords == 0 ? capacity : std::min(maxRecords, capacity), std::memory_order_relaxed);
+    d->maxBytes.store(maxBytes, std::memory_order_relaxed);
+}
+
+void InstanceBase::setOverflowPolicy(OverflowPolicy policy)
+{
+    d->overflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+std::uint64_t InstanceBase::getDroppedCount(Level level) const
+{
+    return d->droppedCounts[static_cast<std::size_t>(level)].load(std::memory_order_relaxed);
+}
+
+bool InstanceBase::hasSharedWorker() const
+{
+    return d->pool != nullptr;
+}
+
+const std::shared_ptr<WorkerPool> &InstanceBase::getSharedSinkWorker() const
+{
+    return d->sinkPool;
+}
+
 void InstanceBase::callInit(const std::string &logfileDir)
 {
     this->init(logfileDir);
 }
 
+void InstanceBase::flush()
+{
+    submitRepeats();
+    d->waitFlushed(d->recordRing.enqueuedCount(), std::nullopt);
+    waitOutputFlushed(std::nullopt);
+}
+
+bool InstanceBase::flush(std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    submitRepeats();
+    const bool isFlushed = d->waitFlushed(d->recordRing.enqueuedCount(), deadline);
+    return waitOutputFlushed(deadline) && isFlushed;
+}
+
+bool InstanceBase::shutdown(std::chrono::milliseconds timeout)
+{
+    const bool isFlushed = flush(timeout);
+    if (!d->stopWorker()) {
+        return isFlushed;
+    }
+    // Очередь закрыта: запись, добавленную после этого барьера, выводит добавивший её поток (см. addRecord)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Не выведенные за отведённое время записи отбрасываются
+    Record record;
+    std::lock_guard<std::mutex> lock(d->outputMx);
+    while (d->recordRing.tryPop(record)) {
+        d->queuedBytes.fetch_sub(record.payloadSize(), std::memory_order_relaxed);
+        d->countDropped(record.level());
+        record.clear();
+    }
+    if (d->takeDroppedSummary(record, true)) {
+        writeRecord(record);
+    }
+    flushOutput();
+    d->publishFlushed();
+    return isFlushed;
+}
+
 void InstanceBase::deinit()
 {
-    d->isWorking.store(false, std::memory_order_release);
-    while (d->threadFut.wait_for(std::chrono::microseconds(1)) != std::future_status::ready) {
-        std::unique_lock<std::mutex> lock(d->notifyMx);
-        d->notifyCV.notify_one();
+    // Приёмники наследника разрушаются после вызова
+    CrashHandler::removeInstance(*this);
+
+    // Очередь выводит рабочий поток, затем он останавливается
+    flush();
+    if (!d->stopWorker()) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Записи, добавленные одновременно с остановкой
+    Record record;
+    std::lock_guard<std::mutex> lock(d->outputMx);
+    while (d->recordRing.tryPop(record)) {
+        writeRecord(record);
+        record.clear();
+    }
+    if (d->takeDroppedSummary(record, true)) {
+        writeRecord(record);
+    }
+    flushOutput();
+    d->publishFlushed();
+}
+
+void InstanceBase::addRecord(Record &&record)
+{
+    if (!d->isWorking.load(std::memory_order_acquire)) {
+        // Рабочий поток завершён (shutdown или ошибка вывода): запись выводится в вызывающем потоке
+        d->drainStopped();
+        d->writeStopped(record);
+        return;
+    }
+
+    const auto bytes = record.payloadSize();
+    const auto level = record.level();
+    const auto policy = d->overflowPolicy.load(std::memory_order_relaxed);
+    const bool isBlocking = policy == OverflowPolicy::Block ||
+                            (policy == OverflowPolicy::KeepWarnings && getLevelSeverity(level) >= getLevelSeverity(Level::Warning));
+
+    // При DropOldest запись добавляется сверх ограничения, лишние старые записи отбросит рабочий поток
+    if (policy != OverflowPolicy::DropOldest) {
+        while (d->isOverLimit(bytes)) {
+            if (!isBlocking) {
+                d->countDropped(level);
+                d->wakeWorker();
+                return;
+            }
+            d->waitSpace([this, bytes]() {
+                return !d->isOverLimit(bytes);
+            });
+            // Рабочий поток остановлен и очередь больше не разбирает
+            if (!d->isWorking.load(std::memory_order_acquire)) {
+                d->drainStopped();
+                d->writeStopped(record);
+                return;
+            }
+        }
+    }
+
+    d->queuedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    while (!d->recordRing.tryPush(std::move(record))) {
+        if (!isBlocking) {
+            d->queuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            d->countDropped(level);
+            d->wakeWorker();
+            return;
+        }
+        // Очередь заполнена: ждём, пока рабочий поток её разберёт
+        d->waitSpace([this]() {
+            return d->recordRing.size() < d->recordRing.capacity();
+        });
+        if (!d->isWorking.load(std::memory_order_acquire)) {
+            d->queuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            d->drainStopped();
+            d->writeStopped(record);
+            return;
+        }
     }
 
-    for (auto& task : d->taskDeq) {
-        task();
+    // Барьер в wakeWorker парный с барьером после остановки рабочего потока: запись выводит
+    // либо остановка (shutdown, deinit), либо этот поток, если остановка уже разобрала очередь
+    d->wakeWorker();
+    if (!d->isWorking.load(std::memory_order_relaxed)) {
+        d->drainStopped();
     }
-    d->taskDeq.clear();
 }
 
-void InstanceBase::addTask(task_t &&tsk)
+void InstanceBase::addRecordSync(const Record &record)
 {
-    std::unique_lock<std::mutex> lock(d->notifyMx);
-    d->taskDeq.emplace_back(std::move(tsk));
-    d->notifyCV.notify_one();
+    writeRecordSync(record);
 }
 
-void InstanceBase::addTaskSync(task_t &&tsk)
+void InstanceBase::writeRecordSync(const Record &record)
 {
     std::lock_guard<std::mutex> lock(d->outputMx);
-    tsk();
+    writeRecord(record);
+    flushOutput();
 }
 
 } // namespace Logger
@@ -8,12 +8,33 @@
 #include <boost/noncopyable.hpp>
 #endif // has <boost/noncopyable.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
-#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+
+#include "crashhandler.hpp"
+#include "record.hpp"
 
 namespace Logger {
 
+class WorkerPool;
+
+/**
+ * @brief The OverflowPolicy enum Поведение при заполнении очереди записей (см. InstanceBase::setQueueLimits)
+ */
+enum class OverflowPolicy {
+    Block,        //! Вызывающий поток ждёт, пока рабочий поток освободит место
+    DropNewest,   //! Новая запись отбрасывается
+    DropOldest,   //! Рабочий поток отбрасывает самые старые записи сверх ограничения.
+                  //! Если очередь заполнена полностью, отбрасывается новая запись
+    KeepWarnings, //! Записи ниже Warning отбрасываются, Warning и Error ожидают места
+};
+
 /**
  * @brief InstanceBase Базовый класс инстанции логгера
  */
@@ -63,9 +84,397 @@ public:
         return inst;
     }
 
+    /**
+     *  @brief getCachedInstance    Запросить глобальную инстанцию логгера через сохранённый указатель
+     *  @note                       Без проверки инициализации статической переменной и создания аргументов
+     *                              getInstance() на каждый вызов. Используется макросами COMPLOG_*
+     */
+    template <typename DerivedInstanceT>
+    static DerivedInstanceT& getCachedInstance() {
+        if (auto inst = s_cachedInstance<DerivedInstanceT>.load(std::memory_order_acquire)) {
+            return *inst;
+        }
+
+        auto& inst = getInstance<DerivedInstanceT>();
+        s_cachedInstance<DerivedInstanceT>.store(&inst, std::memory_order_release);
+        return inst;
+    }
+
+    /**
+     * @brief setLevel  Задать минимальный уровень вывода во время работы
+     * @param level     Уровень. Записи с меньшей важностью (см. getLevelSeverity) отбрасываются
+     */
+    void setLevel(Level level) {
+        m_minSeverity.store(getLevelSeverity(level), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief setSiteLevel  Задать минимальный уровень для мест вызова COMPLOG_* в файле (или на строке файла)
+     * @param file          Окончание пути файла места вызова, например "network/socket.cpp"
+     * @param line          Строка. 0 - все места вызова файла
+     * @param level         Уровень. Для этих мест вызова заменяет setLevel (может быть и ниже него).
+     *                      Правило для строки важнее правила для всего файла
+     * @note                Решение кэшируется в самом месте вызова (CallSite::state) и пересчитывается
+     *                      только после изменения правил
+     */
+    void setSiteLevel(std::string_view file, unsigned line, Level level);
+
+    /**
+     * @brief clearSiteLevels   Удалить правила setSiteLevel
+     */
+    void clearSiteLevels();
+
+    /**
+     * @brief setShowLocation   Выводить место вызова "(file:line) " в конце текстовых записей
+     * @param isShown           По умолчанию false. Действует на записи, форматируемые после вызова.
+     *                          Приёмники получают место вызова в FormattedRecord::site независимо от настройки
+     */
+    void setShowLocation(bool isShown) {
+        m_isLocationShown.store(isShown, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief setCrashHandler   Дописывать в логфайл при аварийном завершении (SIGSEGV, SIGABRT, SIGBUS, SIGFPE)
+     *                          записи, ещё не выведенные приёмниками, и стек вызовов
+     * @param isEnabled         По умолчанию false. Обработчики сигналов устанавливаются при первом включении
+     *                          и остаются до завершения процесса, прежние обработчики вызываются после отчёта
+     * @return                  false, если обработчик недоступен (только POSIX) или включён у слишком многих инстанций
+     * @note                    Отчёт выводится только async-signal-safe операциями: уже отформатированные
+     *                          записи буфера приёмника логфайла и записи очереди, форматируемые без выделения
+     *                          памяти. Записи, которые в момент падения выводит другой поток, могут повториться
+     *                          или потеряться. Стек при переполнении обрабатывается только в потоке, впервые
+     *                          включившем обработчик. Потоки, упавшие во время вывода отчёта, ждут его
+     *                          завершения: процесс завершает сигнал первого упавшего потока
+     */
+    bool setCrashHandler(bool isEnabled);
+
+    /**
+     * @brief setSharedWorkers  Выводить записи инстанций, создаваемых после вызова, общим пулом рабочих потоков
+     * @param threadsCount      Количество потоков пула. 0 - у каждой инстанции свой рабочий поток (по умолчанию)
+     * @note                    Уже созданные инстанции сохраняют прежний способ вывода. Инстанция обслуживается
+     *                          одним потоком пула за раз (порядок её записей сохраняется) и выводит за проход
+     *                          не более одного пакета (см. setBatching), после чего очередь переходит к другим
+     *                          инстанциям. Ожидание заполнения пакета (maxDelay) в пуле не используется.
+     *                          Логфайл таких инстанций выводится тем же потоком пула, консоль - одним общим
+     *                          для них потоком (медленный терминал не задерживает пул). Своих потоков у инстанции
+     *                          нет, кроме приёмников, добавленных пользователем
+     */
+    static void setSharedWorkers(std::size_t threadsCount);
+
+    /**
+     * @brief setBatching   Настроить пакетный вывод записей рабочим потоком
+     * @param maxBatchSize  Максимальное количество записей, выводимых одним сбросом буферов (по умолчанию 1024)
+     * @param maxDelay      Максимальное время ожидания новых записей для заполнения пакета (по умолчанию 0:
+     *                      пакет выводится, как только очередь опустела)
+     */
+    void setBatching(std::size_t maxBatchSize, std::chrono::microseconds maxDelay = {});
+
+    /**
+     * @brief setQueueLimits    Ограничить очередь записей
+     * @param maxRecords        Максимальное количество записей. 0 или значение больше ёмкости очереди (4096)
+     *                          означает ёмкость очереди
+     * @param maxBytes          Максимальный суммарный размер аргументов записей. 0 - без ограничения
+     */
+    void setQueueLimits(std::size_t maxRecords, std::size_t maxBytes = 0);
+
+    /**
+     * @brief setOverflowPolicy Задать поведение при достижении ограничений очереди
+     * @param policy            Поведение. По умолчанию OverflowPolicy::Block
+     * @note                    Количество отброшенных записей выводится в лог строкой-сводкой,
+     *                          когда очередь освобождается
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+
+    /**
+     * @brief getDroppedCount   Количество записей уровня level, отброшенных из-за переполнения очереди
+     */
+    std::uint64_t getDroppedCount(Level level) const;
+
+    /**
+     * @brief flush Дождаться вывода всех записей, добавленных в очередь до вызова
+     * @note        Не вызывать из writeRecord/flushOutput (рабочего потока)
+     */
+    void flush();
+
+    /**
+     * @brief flush     Дождаться вывода всех записей, добавленных в очередь до вызова, не дольше timeout
+     * @return          false, если за timeout записи выведены не полностью
+     */
+    bool flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief shutdown  Завершить рабочий поток, выведя очередь не дольше timeout
+     * @return          false, если за timeout очередь выведена не полностью. Оставшиеся записи
+     *                  отбрасываются и учитываются в getDroppedCount и строке-сводке
+     * @note            Записи, добавленные после завершения, выводятся синхронно в вызывающем потоке.
+     *                  Асинхронные вызовы при этом не бросают исключений: запись, которую не удалось
+     *                  вывести, учитывается в getDroppedCount
+     */
+    bool shutdown(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief isEnabled Проверка уровня перед созданием записи
+     * @return          true, если записи уровня level выводятся
+     */
+    bool isEnabled(Level level) const {
+        return getLevelSeverity(level) >= m_minSeverity.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief setRateLimit      Ограничить частоту записей каждого места вызова (token bucket)
+     * @param recordsPerSecond  Средняя частота записей места вызова. 0 - без ограничения (по умолчанию)
+     * @param burst             Количество записей, допустимых подряд сверх средней частоты
+     * @note                    Проверяется в isEnabledAt до вычисления и копирования аргументов.
+     *                          Количество отброшенных записей выводится строкой "Rate limit: suppressed N records"
+     *                          перед следующей записью этого места вызова
+     */
+    void setRateLimit(double recordsPerSecond, std::size_t burst = 10);
+
+    /**
+     * @brief setDeduplication  Сворачивать подряд повторяющиеся записи места вызова (те же уровень и аргументы)
+     * @param window            Повтор выводится не чаще раза в window, перед ним - строка
+     *                          "Last message repeated N times". 0 - не сворачивать (по умолчанию)
+     * @note                    Проверяется после заполнения записи, но до добавления её в очередь.
+     *                          Если повторы прекратились, строка о них выводится при flush() и shutdown()
+     */
+    void setDeduplication(std::chrono::milliseconds window);
+
+    /**
+     * @brief setSampling   Выводить случайную часть записей уровня (например, одну из 1000 Debug)
+     * @param level         Уровень
+     * @param oneIn         В среднем сохраняется одна запись из oneIn. 0 и 1 - все записи (по умолчанию)
+     * @note                Решение принимается в вызывающем потоке (isEnabledAt, log) до вычисления аргументов
+     *                      по генератору псевдослучайных чисел потока, без общих счётчиков. Сохранённые записи
+     *                      помечаются "(sampled 1/N)", чтобы при анализе можно было восстановить количество
+     */
+    void setSampling(Level level, std::uint32_t oneIn);
+
+    /**
+     * @brief isEnabledAt   Проверка уровня, выборки и ограничения частоты места вызова перед созданием записи
+     * @return              true, если запись места вызова site выводится (используется макросами COMPLOG_*)
+     * @note                Состояние ограничения хранится в самом месте вызова (CallSite::state)
+     */
+    bool isEnabledAt(const CallSite& site) {
+        if (!isSiteEnabled(site) || !isSampledIn(site.level)) {
+            return false;
+        }
+        const auto interval = m_rateIntervalTicks.load(std::memory_order_relaxed);
+        return interval == 0 || isRateAllowed(site.state, interval, m_rateToleranceTicks.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief log Вывести данные в потоке логгирования. Для синхронного вывода
+     * укажите isSync как true
+     * @param args Данные на вывод
+     */
+    template<Level lt, bool isSync, typename... Args>
+    void log(Args&&... args) {
+        if (!isEnabled(lt) || !isSampledIn(lt)) {
+            return;
+        }
+
+        Record record;
+        record.assign(lt, args...);
+        record.setSampleRate(getSampleRate(lt));
+
+        if constexpr (isSync) {
+            addRecordSync(record);
+        } else {
+            addRecord(std::move(record));
+        }
+    }
+
+    /**
+     * @brief logAt Вывести данные с указанием места вызова (используется макросами COMPLOG_*)
+     * @param site  Статическое описание места вызова
+     * @param args  Данные на вывод
+     * @note        Выборка и ограничение частоты не проверяются: перед вызовом нужен isEnabledAt
+     */
+    template<Level lt, bool isSync, typename... Args>
+    void logAt(const CallSite& site, Args&&... args) {
+        if (!isSiteEnabled(site)) {
+            return;
+        }
+
+        Record record;
+        record.assign(site, args...);
+        record.setSampleRate(getSampleRate(lt));
+        submitRecordAt<isSync>(site, std::move(record));
+    }
+
+    /**
+     * @brief logKv     Вывести структурированную запись: сообщение и именованные поля
+     * @param message   Сообщение
+     * @param fields    Имена полей (строки) и значения через одного. Типы значений сохраняются до
+     *                  приёмников (см. Sink::isStructured), в тексте поля выводятся как name=value
+     */
+    template<Level lt, bool isSync, typename Message, typename... Fields>
+    void logKv(const Message& message, const Fields&... fields) {
+        if (!isEnabled(lt) || !isSampledIn(lt)) {
+            return;
+        }
+
+        Record record;
+        record.assignFields(lt, message, fields...);
+        record.setSampleRate(getSampleRate(lt));
+        submitRecord<isSync>(std::move(record));
+    }
+
+    /**
+     * @brief logKvAt   Вывести структурированную запись с указанием места вызова (используется макросами COMPLOG_*_KV)
+     * @note            Выборка и ограничение частоты не проверяются: перед вызовом нужен isEnabledAt
+     */
+    template<Level lt, bool isSync, typename Message, typename... Fields>
+    void logKvAt(const CallSite& site, const Message& message, const Fields&... fields) {
+        if (!isSiteEnabled(site)) {
+            return;
+        }
+
+        Record record;
+        record.assignFields(site, message, fields...);
+        record.setSampleRate(getSampleRate(lt));
+        submitRecordAt<isSync>(site, std::move(record));
+    }
+
 private:
     struct Impl;
     std::unique_ptr<Impl> d;
+    std::atomic<int> m_minSeverity {getLevelSeverity(Level::Debug)}; //! Минимальная важность выводимых записей
+    std::atomic<std::uint64_t> m_rateIntervalTicks {0};  //! Интервал между записями места вызова, 0 - без ограничения
+    std::atomic<std::uint64_t> m_rateToleranceTicks {0}; //! Допустимое опережение расчётного момента (burst)
+    std::atomic<std::uint64_t> m_dedupWindowTicks {0};   //! Окно сворачивания повторов, 0 - не сворачивать
+    std::atomic<std::uint32_t> m_sampleRates[LEVELS_COUNT] {1, 1, 1, 1, 1, 1}; //! Сохраняется одна запись из N
+    std::atomic<std::uint64_t> m_siteRulesVersion {0};   //! Версия правил setSiteLevel, 0 - правил нет
+    std::atomic<bool> m_isLocationShown {false};
+
+    //! Порог места вызова в CallSiteState::filterCache, если ни одно правило setSiteLevel не подходит
+    static constexpr std::uint64_t NO_SITE_RULE {0xff};
+
+    /**
+     * @brief isSiteEnabled Проверка уровня места вызова с учётом правил setSiteLevel
+     */
+    bool isSiteEnabled(const CallSite& site) const {
+        const auto version = m_siteRulesVersion.load(std::memory_order_acquire);
+        if (version == 0) {
+            return isEnabled(site.level);
+        }
+        // Старшие биты - версия правил, младший байт - порог места вызова по этой версии
+        const auto cached = site.state.filterCache.load(std::memory_order_relaxed);
+        const auto severity = (cached >> 8) == version ? (cached & 0xff) : updateSiteSeverity(site);
+        return severity == NO_SITE_RULE ? isEnabled(site.level)
+                                        : static_cast<std::uint64_t>(getLevelSeverity(site.level)) >= severity;
+    }
+
+    /**
+     * @brief updateSiteSeverity    Подобрать правило setSiteLevel для места вызова и сохранить порог в его состоянии
+     * @return                      Порог (важность уровня) или NO_SITE_RULE
+     */
+    std::uint64_t updateSiteSeverity(const CallSite& site) const;
+
+    std::uint32_t getSampleRate(Level level) const {
+        return m_sampleRates[static_cast<std::size_t>(level)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief isSampledIn   Решение о сохранении записи уровня level при выборке
+     */
+    bool isSampledIn(Level level) const {
+        const auto rate = getSampleRate(level);
+        // Старшие 32 бита случайного числа, умноженные на rate: 0 с вероятностью 1/rate
+        return rate <= 1 || (((nextRandom() >> 32) * rate) >> 32) == 0;
+    }
+
+    /**
+     * @brief nextRandom Генератор xorshift64* своего для каждого потока
+     */
+    static std::uint64_t nextRandom() {
+        thread_local std::uint64_t state {0};
+        if (state == 0) {
+            // splitmix64 от момента времени и адреса состояния потока
+            auto seed = Clock::now() ^ reinterpret_cast<std::uintptr_t>(&state);
+            seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ull;
+            seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebull;
+            state = (seed ^ (seed >> 31)) | 1;
+        }
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    /**
+     * @brief isRateAllowed Взять маркер места вызова (GCRA: одна атомарная переменная на место вызова)
+     */
+    static bool isRateAllowed(CallSiteState& state, std::uint64_t interval, std::uint64_t tolerance) {
+        const auto now = Clock::now();
+        auto expected = state.rateTicks.load(std::memory_order_relaxed);
+        for (;;) {
+            const auto start = std::max(expected, now);
+            if (start - now > tolerance) {
+                state.rateSuppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (state.rateTicks.compare_exchange_weak(expected, start + interval, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief isRepeated    Проверка повтора последней выведенной записи места вызова
+     * @param repeated      Количество свёрнутых повторов, которое нужно вывести перед записью
+     * @return              true, если запись сворачивается
+     */
+    bool isRepeated(const CallSite& site, const Record& record, std::uint64_t window, std::uint64_t& repeated);
+
+    /**
+     * @brief submitRepeats Вывести строки о свёрнутых повторах, после которых записей места вызова не было
+     */
+    void submitRepeats();
+
+    template <bool isSync>
+    void submitRecord(Record&& record) {
+        if constexpr (isSync) {
+            addRecordSync(record);
+        } else {
+            addRecord(std::move(record));
+        }
+    }
+
+    /**
+     * @brief submitRecordAt    Вывести запись места вызова вместе со сводками подавленных записей
+     */
+    template <bool isSync>
+    void submitRecordAt(const CallSite& site, Record&& record) {
+        const auto window = m_dedupWindowTicks.load(std::memory_order_relaxed);
+        std::uint64_t repeated {0};
+        if (window != 0 && isRepeated(site, record, window, repeated)) {
+            return;
+        }
+        if (repeated != 0) {
+            Record note;
+            note.assign(site, "Last message repeated", repeated, "times");
+            submitRecord<isSync>(std::move(note));
+        }
+        if (site.state.rateSuppressed.load(std::memory_order_relaxed) != 0) {
+            if (const auto suppressed = site.state.rateSuppressed.exchange(0, std::memory_order_relaxed)) {
+                Record note;
+                note.assign(site, "Rate limit: suppressed", suppressed, "records");
+                submitRecord<isSync>(std::move(note));
+            }
+        }
+        submitRecord<isSync>(std::move(record));
+    }
+
+    template <typename DerivedInstanceT>
+    static inline std::atomic<DerivedInstanceT*> s_cachedInstance {nullptr};
+
+    friend class CrashHandler;
+
+    /**
+     * @brief writeCrashReport  Вывести не выведенные записи инстанции из обработчика сигнала
+     */
+    void writeCrashReport(CrashWriter& writer);
 
     void callInit(const std::string &logfileDir);
 
@@ -73,9 +482,69 @@ protected:
     virtual void init(const std::string& logfileDir) = 0;
     void deinit();
 
-    using task_t = std::function<void()>;
-    void addTask(task_t&& tsk);
-    void addTaskSync(task_t&& tsk);
+    bool isLocationShown() const {
+        return m_isLocationShown.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief hasSharedWorker   Записи инстанции выводит общий пул (см. setSharedWorkers), а не свой поток
+     */
+    bool hasSharedWorker() const;
+
+    /**
+     * @brief getSharedSinkWorker   Общий поток встроенных приёмников инстанций пула, которые не должны
+     *                              выводиться потоком пула (консоль). nullptr - инстанция не в общем пуле
+     */
+    const std::shared_ptr<WorkerPool>& getSharedSinkWorker() const;
+
+    /**
+     * @brief flushOutput Вывести накопленный пакет записей. Вызывается после каждого пакета и синхронной записи
+     */
+    virtual void flushOutput() {}
+
+    /**
+     * @brief waitOutputFlushed Дождаться вывода записей, переданных приёмникам (flush после очереди записей)
+     * @param deadline          Крайний момент ожидания (std::nullopt - без ограничения)
+     * @return                  false, если за отведённое время записи выведены не полностью
+     */
+    virtual bool waitOutputFlushed(std::optional<std::chrono::steady_clock::time_point> /*deadline*/) {
+        return true;
+    }
+
+    /**
+     * @brief writeRecord   Добавить запись в пакет. Вызывается в рабочем потоке либо, для синхронного вывода, в вызывающем
+     * @param record        Запись лога
+     */
+    virtual void writeRecord(const Record& record) = 0;
+
+    /**
+     * @brief writeRecordSync   Вывести запись синхронно в вызывающем потоке
+     * @param record            Запись лога
+     * @note                    По умолчанию выполняется под общей блокировкой вывода вместе с рабочим потоком
+     *                          (writeRecord + flushOutput). Наследник может форматировать запись без неё,
+     *                          блокируя только приёмники на время записи. Порядок относительно асинхронных
+     *                          записей, ещё не выведенных рабочим потоком, при этом не гарантируется
+     */
+    virtual void writeRecordSync(const Record& record);
+
+    /**
+     * @brief getCrashLogfile   Путь файла для отчёта о падении (см. setCrashHandler, FileWriterBase::getSignalSafePath)
+     * @return                  nullptr - отчёт не выводится
+     * @note                    Вызывается из обработчика сигнала
+     */
+    virtual const char* getCrashLogfile() const {
+        return nullptr;
+    }
+
+    /**
+     * @brief writeCrashRecords Вывести записи, переданные приёмникам, но ещё не выведенные ими
+     * @note                    Вызывается из обработчика сигнала перед записями очереди: только
+     *                          async-signal-safe операции, без блокировок и выделения памяти
+     */
+    virtual void writeCrashRecords(CrashWriter& /*writer*/) {}
+
+    void addRecord(Record&& record);
+    void addRecordSync(const Record& record);
 };
 
 } // namespace Logger
@@ -5,7 +5,9 @@
 #include "qt/logger.hpp"
 #else
 #include "noqt/logger.hpp"
+#include "noqt/jsonlinessink.hpp"
 #endif // COMPONENTS_IS_ENABLED_QT
+#include "filesinks.hpp"
 
 // Для вывода информации о типе объекта
 #if __has_include(<boost/core/demangle.hpp>)
@@ -21,6 +23,7 @@ namespace Logger
 using Instance = LoggerQt::Instance;
 #else
 using Instance = LoggerNoQt::Instance;
+using JsonLinesSink = LoggerNoQt::JsonLinesSink;
 #endif // COMPONENTS_IS_ENABLED_QT
 
 }
@@ -32,11 +35,47 @@ using Instance = LoggerNoQt::Instance;
 #define COMPLOG_GET_LOGFILE() \
     Logger::Instance::getInstance<Logger::Instance>().getFilewriter().getLogfilePath()
 
+// Минимальный уровень вывода во время работы (например, Logger::Level::Warning)
+#define COMPLOG_SET_LEVEL(logLevel) \
+    Logger::Instance::getInstance<Logger::Instance>().setLevel(logLevel)
+
+// Формат логфайла (Logger::OutputFormat::Text или Logger::OutputFormat::Binary)
+#define COMPLOG_SET_OUTPUT_FORMAT(outputFormat) \
+    Logger::Instance::getInstance<Logger::Instance>().setOutputFormat(outputFormat)
+
+
+// Минимальный уровень вывода (Debug, Info, Warning, Error). Вызовы COMPLOG_* ниже него удаляются
+// при компиляции вместе с вычислением аргументов. Задаётся для каждой единицы трансляции
+#ifndef COMPLOG_MIN_LEVEL
+#define COMPLOG_MIN_LEVEL Debug
+#endif // COMPLOG_MIN_LEVEL
+
 
 // Базовый макрос для COMPLOG_*
-#define COMPLOG_PRIVATE_LOG_BASE(logLevel, logIsSync, ...)   \
-    Logger::Instance::getInstance<Logger::Instance>()       \
-        .log<Logger::Level::logLevel, logIsSync>(__VA_ARGS__)
+// Уровень, заданный через COMPLOG_SET_LEVEL, и ограничение частоты места вызова проверяются до вычисления аргументов
+#define COMPLOG_PRIVATE_LOG_BASE(logLevel, logIsSync, ...)                                          \
+    [&]() {                                                                                         \
+        if constexpr (Logger::isLevelEnabled<Logger::Level::logLevel, Logger::Level::COMPLOG_MIN_LEVEL>()) { \
+            auto& complogInstance = Logger::Instance::getCachedInstance<Logger::Instance>();       \
+            const auto& complogSite = COMPLOG_PRIVATE_CALLSITE(logLevel);                           \
+            if (complogInstance.isEnabledAt(complogSite)) {                                         \
+                complogInstance.logAt<Logger::Level::logLevel, logIsSync>(complogSite __VA_OPT__(,) __VA_ARGS__); \
+            }                                                                                       \
+        }                                                                                           \
+    }()
+
+
+// Базовый макрос для COMPLOG_*_KV: сообщение и пары "имя поля, значение"
+#define COMPLOG_PRIVATE_LOG_KV_BASE(logLevel, logIsSync, ...)                                       \
+    [&]() {                                                                                         \
+        if constexpr (Logger::isLevelEnabled<Logger::Level::logLevel, Logger::Level::COMPLOG_MIN_LEVEL>()) { \
+            auto& complogInstance = Logger::Instance::getCachedInstance<Logger::Instance>();       \
+            const auto& complogSite = COMPLOG_PRIVATE_CALLSITE(logLevel);                           \
+            if (complogInstance.isEnabledAt(complogSite)) {                                         \
+                complogInstance.logKvAt<Logger::Level::logLevel, logIsSync>(complogSite __VA_OPT__(,) __VA_ARGS__); \
+            }                                                                                       \
+        }                                                                                           \
+    }()
 
 
 // Параллельный логгер (макросы вывода данных через другой поток)
@@ -53,6 +92,13 @@ using Instance = LoggerNoQt::Instance;
 #define COMPLOG_ERROR(...)     COMPLOG_PRIVATE_LOG_BASE(Error,   false, __VA_ARGS__)
 #define COMPLOG_OK(...)        COMPLOG_PRIVATE_LOG_BASE(Ok,      false, __VA_ARGS__)
 
+// Структурированные записи: COMPLOG_INFO_KV("Request done", "status", 200, "elapsed_ms", 12.5)
+#define COMPLOG_DEBUG_KV(...)     COMPLOG_PRIVATE_LOG_KV_BASE(Debug,   false, __VA_ARGS__)
+#define COMPLOG_INFO_KV(...)      COMPLOG_PRIVATE_LOG_KV_BASE(Info,    false, __VA_ARGS__)
+#define COMPLOG_WARNING_KV(...)   COMPLOG_PRIVATE_LOG_KV_BASE(Warning, false, __VA_ARGS__)
+#define COMPLOG_ERROR_KV(...)     COMPLOG_PRIVATE_LOG_KV_BASE(Error,   false, __VA_ARGS__)
+#define COMPLOG_OK_KV(...)        COMPLOG_PRIVATE_LOG_KV_BASE(Ok,      false, __VA_ARGS__)
+
 
 // Синхронная версия логгера (макросы вывода данных через текущий поток)
 #if __has_include(<boost/core/demangle.hpp>)
@@ -68,6 +114,12 @@ using Instance = LoggerNoQt::Instance;
 #define COMPLOG_SYNC_ERROR(...)     COMPLOG_PRIVATE_LOG_BASE(Error,   true, __VA_ARGS__)
 #define COMPLOG_SYNC_OK(...)        COMPLOG_PRIVATE_LOG_BASE(Ok,      true, __VA_ARGS__)
 
+#define COMPLOG_SYNC_DEBUG_KV(...)     COMPLOG_PRIVATE_LOG_KV_BASE(Debug,   true, __VA_ARGS__)
+#define COMPLOG_SYNC_INFO_KV(...)      COMPLOG_PRIVATE_LOG_KV_BASE(Info,    true, __VA_ARGS__)
+#define COMPLOG_SYNC_WARNING_KV(...)   COMPLOG_PRIVATE_LOG_KV_BASE(Warning, true, __VA_ARGS__)
+#define COMPLOG_SYNC_ERROR_KV(...)     COMPLOG_PRIVATE_LOG_KV_BASE(Error,   true, __VA_ARGS__)
+#define COMPLOG_SYNC_OK_KV(...)        COMPLOG_PRIVATE_LOG_KV_BASE(Ok,      true, __VA_ARGS__)
+
 
 // Обратная совместимость со старой версией дефайнов
 #define COMPLOG_EMPTY_SYNC(...)     COMPLOG_SYNC_EMPTY(__VA_ARGS__)
@@ -0,0 +1,215 @@
+#include "mappedfilewriter.hpp"
+
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Logger
+{
+
+/**
+ * @brief preallocate   Выделить место в файле под блок, расширив файл
+ * @note                Если файловая система не поддерживает fallocate, файл расширяется через ftruncate
+ */
+static bool preallocate(int fd, std::uint64_t offset, std::uint64_t size)
+{
+#ifdef __linux__
+    if (fallocate(fd, 0, static_cast<off_t>(offset), static_cast<off_t>(size)) == 0) {
+        return true;
+    }
+#else
+    if (posix_fallocate(fd, static_cast<off_t>(offset), static_cast<off_t>(size)) == 0) {
+        return true;
+    }
+#endif
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        return false;
+    }
+    if (static_cast<std::uint64_t>(fileStat.st_size) >= offset + size) {
+        return true;
+    }
+    return ftruncate(fd, static_cast<off_t>(offset + size)) == 0;
+}
+
+/**
+ * @brief findWrittenLength Найти длину записанного текста, отбросив нулевой хвост предвыделенного блока
+ * @note                    Хвост остаётся, если процесс завершился аварийно и файл не был обрезан.
+ *                          Отформатированный текст не содержит нулевых байт
+ */
+static std::uint64_t findWrittenLength(int fd, std::uint64_t size)
+{
+    char buffer[64 * 1024];
+    while (size > 0) {
+        const auto chunk = std::min<std::uint64_t>(size, sizeof(buffer));
+        if (pread(fd, buffer, chunk, static_cast<off_t>(size - chunk)) != static_cast<ssize_t>(chunk)) {
+            return size;
+        }
+        const auto last = std::find_if(std::make_reverse_iterator(buffer + chunk), std::make_reverse_iterator(buffer),
+                                       [](char ch) { return ch != '\0'; });
+        if (last != std::make_reverse_iterator(buffer)) {
+            return size - chunk + static_cast<std::uint64_t>(last.base() - buffer);
+        }
+        size -= chunk;
+    }
+    return 0;
+}
+
+MappedFileWriter::MappedFileWriter(std::size_t extentSize)
+{
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    m_extentSize = extentSize == 0 ? pageSize : (extentSize + pageSize - 1) / pageSize * pageSize;
+}
+
+MappedFileWriter::~MappedFileWriter()
+{
+    close();
+}
+
+void MappedFileWriter::setLogfile(const std::string &filePath)
+{
+    lockFile();
+    closeLogfile();
+    FileWriterBase::setLogfile(filePath);
+    unlockFile();
+}
+
+void MappedFileWriter::setLogfile(const std::string_view &filePath)
+{
+    setLogfile(std::string(filePath));
+}
+
+void MappedFileWriter::write(const char *data, std::size_t size)
+{
+    lockFile();
+    if (isRotationNeeded(size)) {
+        closeLogfile();
+        rotateLogfile();
+    }
+    if (m_fd < 0 && !openLogfile()) {
+        unlockFile();
+        throw std::runtime_error(
+                    std::string("Error opening logfile (logfile path: ") +
+                    getLogfilePath().data() + ")");
+    }
+
+    while (size > 0) {
+        const auto mappingEnd = m_mappingOffset + m_extentSize;
+        if (m_mapping == nullptr || m_length >= mappingEnd) {
+            if (!mapExtent(m_length / m_extentSize * m_extentSize)) {
+                closeLogfile();
+                unlockFile();
+                throw std::runtime_error(
+                            std::string("Error mapping logfile (logfile path: ") +
+                            getLogfilePath().data() + ")");
+            }
+            continue;
+        }
+
+        const auto chunk = std::min<std::uint64_t>(size, mappingEnd - m_length);
+        std::memcpy(m_mapping + (m_length - m_mappingOffset), data, chunk);
+        m_length += chunk;
+        data += chunk;
+        size -= chunk;
+        countWrittenSize(chunk);
+    }
+    unlockFile();
+}
+
+void MappedFileWriter::flush()
+{
+    lockFile();
+    if (m_mapping != nullptr) {
+        msync(m_mapping, m_extentSize, MS_ASYNC);
+    }
+    unlockFile();
+}
+
+void MappedFileWriter::close()
+{
+    lockFile();
+    closeLogfile();
+    unlockFile();
+}
+
+bool MappedFileWriter::openLogfile()
+{
+    if (!hasLogfile()) {
+        return false;
+    }
+    m_fd = ::open(getLogfilePath().data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(m_fd, &fileStat) != 0) {
+        closeLogfile();
+        return false;
+    }
+    // Новые записи продолжают текст, а не следуют за нулями блока, оставшимися после аварии
+    const auto size = static_cast<std::uint64_t>(fileStat.st_size);
+    m_length = findWrittenLength(m_fd, size);
+    if (m_length != size && ftruncate(m_fd, static_cast<off_t>(m_length)) != 0) {
+        closeLogfile();
+        return false;
+    }
+    countOpenedSize();
+    return true;
+}
+
+void MappedFileWriter::closeLogfile()
+{
+    if (m_fd < 0) {
+        return;
+    }
+    unmapExtent();
+    // Убираем предвыделенный, но не записанный хвост
+    if (ftruncate(m_fd, static_cast<off_t>(m_length)) != 0) {
+        // Файл останется с нулевым хвостом, данные не теряются
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    m_length = 0;
+}
+
+bool MappedFileWriter::mapExtent(std::uint64_t offset)
+{
+    unmapExtent();
+    if (!preallocate(m_fd, offset, m_extentSize)) {
+        return false;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    // Страницы блока подгружаются сразу, а не по одной при первой записи
+    flags |= MAP_POPULATE;
+#endif
+    void* mapping = mmap(nullptr, m_extentSize, PROT_READ | PROT_WRITE, flags, m_fd, static_cast<off_t>(offset));
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    m_mapping = static_cast<char*>(mapping);
+    m_mappingOffset = offset;
+    return true;
+}
+
+void MappedFileWriter::unmapExtent()
+{
+    if (m_mapping != nullptr) {
+        munmap(m_mapping, m_extentSize);
+        m_mapping = nullptr;
+    }
+}
+
+}
+
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
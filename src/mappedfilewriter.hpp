@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * @file mappedfilewriter.hpp Файл с определением записи логфайла через отображение в память
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define COMPLOG_PRIVATE_HAS_MAPPED_FILE
+#endif
+
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "filewriterbase.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The MappedFileWriter class Запись отформатированного текста в логфайл через mmap
+ * @note  Файл заранее расширяется (fallocate) блоками по extentSize и отображается в память,
+ *        запись сводится к копированию без системных вызовов. При закрытии и ротации файл
+ *        обрезается до фактической длины. Данные, скопированные в отображение, попадают
+ *        в страничный кэш сразу и сохраняются при аварийном завершении процесса
+ *        (хвост файла после аварии заполнен нулями до конца блока и отбрасывается при открытии)
+ */
+class MappedFileWriter final : public FileWriterBase
+{
+public:
+    //! Размер блока, на который расширяется и отображается файл, по умолчанию
+    static constexpr std::size_t DEFAULT_EXTENT_SIZE {16 * 1024 * 1024};
+
+    /**
+     * @param extentSize Размер блока. Округляется вверх до размера страницы
+     */
+    explicit MappedFileWriter(std::size_t extentSize = DEFAULT_EXTENT_SIZE);
+    ~MappedFileWriter();
+
+    void setLogfile(const std::string& filePath) override;
+    void setLogfile(const std::string_view& filePath) override;
+
+    /**
+     * @brief write Записать в файл отформатированный текст (например, пакет записей)
+     * @param data  Текст
+     * @param size  Размер текста
+     */
+    void write(const char* data, std::size_t size);
+
+    /**
+     * @brief flush Запросить у ОС асинхронную запись отображения на диск (msync MS_ASYNC)
+     */
+    void flush();
+
+    /**
+     * @brief close Закрыть файл, обрезав его до фактической длины
+     */
+    void close();
+
+private:
+    std::size_t   m_extentSize;       //! Размер блока отображения
+    int           m_fd {-1};          //! Дескриптор логфайла
+    char*         m_mapping {nullptr}; //! Текущий отображённый блок
+    std::uint64_t m_mappingOffset {0}; //! Смещение блока в файле
+    std::uint64_t m_length {0};        //! Фактическая длина данных в файле
+
+    bool openLogfile();
+    void closeLogfile();
+    bool mapExtent(std::uint64_t offset);
+    void unmapExtent();
+};
+
+}
+
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
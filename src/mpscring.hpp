@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * @file mpscring.hpp Файл с определением ограниченной lock-free очереди
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Logger
+{
+
+//! Размер кэш-линии, по которому разносятся индексы производителей и потребителя
+constexpr std::size_t CACHE_LINE_SIZE {64};
+
+/**
+ * @brief The MpscRing class Ограниченный кольцевой буфер для многих производителей и одного потребителя
+ * @note Каждая ячейка хранит счётчик последовательности (схема Д. Вьюкова), поэтому производители
+ *       не блокируют друг друга, а потребитель не использует атомарных RMW-операций
+ */
+template <typename T>
+class MpscRing
+{
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+public:
+    /**
+     * @brief MpscRing  Конструктор
+     * @param capacity  Ёмкость буфера. Округляется вверх до степени двойки
+     */
+    explicit MpscRing(std::size_t capacity) {
+        std::size_t realCapacity {2};
+        while (realCapacity < capacity) {
+            realCapacity <<= 1;
+        }
+
+        m_mask = realCapacity - 1;
+        m_cells.reset(new Cell[realCapacity]);
+        for (std::size_t i = 0; i < realCapacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator =(const MpscRing&) = delete;
+
+    /**
+     * @brief tryPush   Поместить элемент в буфер. Может вызываться из любого потока
+     * @param value     Элемент. Перемещается только при успехе
+     * @return          false, если буфер заполнен
+     */
+    template <typename U>
+    bool tryPush(U&& value) {
+        Cell* cell;
+        auto pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief tryPop    Извлечь элемент из буфера. Только для потока-потребителя
+     * @param value     Куда переместить элемент
+     * @return          false, если готовых элементов нет
+     */
+    bool tryPop(T& value) {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        auto& cell = m_cells[head & m_mask];
+        auto seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != head + 1) {
+            return false;
+        }
+
+        value = std::move(cell.data);
+        cell.sequence.store(head + m_mask + 1, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief visitReady    Обойти готовые элементы от старых к новым без извлечения
+     * @note                Для отчёта о падении процесса: обход не согласован с одновременным
+     *                      извлечением, элемент может быть прочитан во время перемещения потребителем
+     */
+    template <typename F>
+    void visitReady(F&& visitor) const {
+        const auto head = m_head.load(std::memory_order_acquire);
+        for (auto pos = head; pos - head <= m_mask; ++pos) {
+            const auto& cell = m_cells[pos & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                return;
+            }
+            visitor(cell.data);
+        }
+    }
+
+    /**
+     * @brief empty Проверка наличия готового элемента. Только для потока-потребителя
+     */
+    bool empty() const {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        return m_cells[head & m_mask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    /**
+     * @brief size  Приблизительное количество элементов (включая занятые, но ещё не заполненные ячейки).
+     *              Может вызываться из любого потока
+     */
+    std::size_t size() const {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief enqueuedCount Количество элементов, помещённых в буфер за всё время (включая ещё не заполненные)
+     */
+    std::size_t enqueuedCount() const {
+        return m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief dequeuedCount Количество элементов, извлечённых из буфера за всё время
+     */
+    std::size_t dequeuedCount() const {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const {
+        return m_mask + 1;
+    }
+
+private:
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t             m_mask {0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail {0};  //! Позиция записи (производители)
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head {0};  //! Позиция чтения (потребитель)
+};
+
+}
@@ -0,0 +1,91 @@
+#include "consolewriter.hpp"
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace LoggerNoQt
+{
+
+// Если буфер stdout превысил этот размер, он выводится до окончания пакета
+static constexpr std::size_t CONSOLE_BUFFER_LIMIT = 64 * 1024;
+
+static bool isTerminal(std::FILE* file)
+{
+#ifdef _WIN32
+    return _isatty(_fileno(file)) != 0;
+#else
+    return isatty(fileno(file)) != 0;
+#endif
+}
+
+static void writeBuffer(std::ostream& stream, TextBuffer& buffer)
+{
+    if (buffer.empty()) {
+        return;
+    }
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    stream.flush();
+    buffer.clear();
+}
+
+ConsoleWriter::ConsoleWriter() :
+    m_stdoutIsTty {isTerminal(stdout)},
+    m_stderrIsTty {isTerminal(stderr)}
+{
+
+}
+
+void ConsoleWriter::setColorMode(ColorMode mode)
+{
+    m_colorMode.store(mode, std::memory_order_relaxed);
+}
+
+ConsoleWriter::ColorMode ConsoleWriter::getColorMode() const
+{
+    return m_colorMode.load(std::memory_order_relaxed);
+}
+
+void ConsoleWriter::write(const FormattedRecord &record)
+{
+    const bool isStderr = record.level == Level::Error || record.level == Level::Warning;
+    record.appendTo(isStderr ? m_stderrBuffer : m_stdoutBuffer, isColored(isStderr ? m_stderrIsTty : m_stdoutIsTty));
+
+    if (isStderr) {
+        // Предшествующие записи stdout выводятся первыми, чтобы сохранить порядок в терминале
+        writeBuffer(std::cout, m_stdoutBuffer);
+        writeBuffer(std::cerr, m_stderrBuffer);
+    } else if (m_stdoutBuffer.size() >= CONSOLE_BUFFER_LIMIT) {
+        writeBuffer(std::cout, m_stdoutBuffer);
+    }
+}
+
+void ConsoleWriter::flush()
+{
+    writeBuffer(std::cout, m_stdoutBuffer);
+    writeBuffer(std::cerr, m_stderrBuffer);
+}
+
+bool ConsoleWriter::isColored(bool isTty) const
+{
+    switch (m_colorMode.load(std::memory_order_relaxed)) {
+        case ColorMode::Always:
+            return true;
+        case ColorMode::Never:
+            return false;
+        case ColorMode::Auto:
+            break;
+    }
+    return isTty;
+}
+
+}
+
+#endif // COMPONENTS_IS_ENABLED_QT
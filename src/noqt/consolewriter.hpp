@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+
+#include <atomic>
+
+#include "../common.hpp"
+#include "../sink.hpp"
+
+namespace LoggerNoQt
+{
+
+using namespace Logger;
+
+/**
+ * @brief The ConsoleWriter class  Буферизованный вывод записей в stdout/stderr
+ * @note  Записи накапливаются в буфере и выводятся одной операцией на границе пакета (flush).
+ *        Error и Warning идут в stderr и выводятся сразу, вместе с предшествующими записями stdout
+ */
+class ConsoleWriter final : public Sink
+{
+public:
+    /**
+     * @brief The ColorMode enum Режим выделения уровня цветом
+     */
+    enum class ColorMode {
+        Auto,   //! Цвет только если поток вывода является терминалом
+        Always, //! Всегда выводить управляющие последовательности
+        Never,  //! Никогда не выводить управляющие последовательности
+    };
+
+    ConsoleWriter();
+
+    ConsoleWriter(const ConsoleWriter&) = delete;
+    ConsoleWriter& operator =(const ConsoleWriter&) = delete;
+
+    /**
+     * @brief setColorMode  Задать режим выделения цветом
+     * @param mode          Режим. По умолчанию ColorMode::Auto
+     */
+    void setColorMode(ColorMode mode);
+    ColorMode getColorMode() const;
+
+    /**
+     * @brief write     Вывести запись в буфер соответствующего потока.
+     *                  Для Error и Warning буферы сразу выводятся в консоль
+     * @param record    Отформатированная запись
+     */
+    void write(const FormattedRecord& record) override;
+
+    /**
+     * @brief flush Вывести накопленные записи в консоль
+     */
+    void flush() override;
+
+private:
+    bool isColored(bool isTty) const;
+
+    std::atomic<ColorMode> m_colorMode {ColorMode::Auto};
+    const bool m_stdoutIsTty; //! stdout является терминалом (проверяется один раз)
+    const bool m_stderrIsTty; //! stderr является терминалом (проверяется один раз)
+
+    TextBuffer m_stdoutBuffer; //! Пакет записей для вывода в stdout
+    TextBuffer m_stderrBuffer; //! Пакет записей для вывода в stderr
+};
+
+}
+
+#endif // COMPONENTS_IS_ENABLED_QT
@@ -2,11 +2,146 @@
 
 #ifndef COMPONENTS_IS_ENABLED_QT
 
-#include <mutex>
-
 namespace LoggerNoQt
 {
 
+// Размер буфера записи в файл
+constexpr std::size_t LOGFILE_BUFFER_SIZE {64 * 1024};
+
+FileWriter::FileWriter() :
+    m_logfileBuffer(LOGFILE_BUFFER_SIZE)
+{
+
+}
+
+FileWriter::~FileWriter()
+{
+    lockFile();
+    if (m_logfile.is_open()) {
+        m_logfile.close();
+    }
+    unlockFile();
+}
+
+void FileWriter::setLogfile(const std::string &filePath)
+{
+    lockFile();
+    FileWriterBase::setLogfile(filePath);
+    if (m_openMode == OpenMode::Persistent) {
+        openLogfile();
+    }
+    unlockFile();
+}
+
+void FileWriter::setLogfile(const std::string_view &filePath)
+{
+    setLogfile(std::string(filePath));
+}
+
+void FileWriter::setOpenMode(OpenMode mode)
+{
+    lockFile();
+    m_openMode = mode;
+    if (m_logfile.is_open()) {
+        m_logfile.close();
+    }
+    unlockFile();
+}
+
+FileWriter::OpenMode FileWriter::getOpenMode() const
+{
+    return m_openMode;
+}
+
+void FileWriter::reopen()
+{
+    lockFile();
+    if (m_openMode == OpenMode::Persistent) {
+        openLogfile();
+    }
+    unlockFile();
+}
+
+void FileWriter::requestReopen()
+{
+    m_reopenRequested.store(true, std::memory_order_relaxed);
+}
+
+void FileWriter::flush()
+{
+    lockFile();
+    if (m_logfile.is_open()) {
+        m_logfile.flush();
+    }
+    unlockFile();
+}
+
+void FileWriter::write(const char *data, std::size_t size)
+{
+    lockFile();
+    if (isRotationNeeded(size)) {
+        if (m_logfile.is_open()) {
+            m_logfile.close();
+        }
+        rotateLogfile();
+    }
+    if (!prepareLogfile()) {
+        unlockFile();
+        throw std::runtime_error(
+                    std::string("Error opening logfile (logfile path: ") +
+                    getLogfilePath().data() + ")");
+    }
+    m_logfile.write(data, static_cast<std::streamsize>(size));
+    countWrittenSize(size);
+
+    finishRecord();
+    unlockFile();
+}
+
+bool FileWriter::openLogfile()
+{
+    if (m_logfile.is_open()) {
+        m_logfile.close();
+    }
+    m_logfile.clear();
+    if (!hasLogfile()) {
+        return false;
+    }
+
+    // Буфер должен быть задан до открытия файла
+    m_logfile.rdbuf()->pubsetbuf(m_logfileBuffer.data(), m_logfileBuffer.size());
+    m_logfile.open(getLogfilePath().data(), std::ios_base::out | std::ios_base::app);
+    countOpenedSize();
+    return m_logfile.is_open();
+}
+
+bool FileWriter::prepareLogfile()
+{
+    if (m_openMode == OpenMode::Reopen) {
+        return openLogfile();
+    }
+
+    if (m_reopenRequested.exchange(false, std::memory_order_relaxed) ||
+        !m_logfile.is_open() || !m_logfile.good()) {
+        return openLogfile();
+    }
+    return true;
+}
+
+void FileWriter::finishRecord()
+{
+    if (m_openMode == OpenMode::Reopen) {
+        m_logfile.flush();
+        m_logfile.close();
+        return;
+    }
+
+    // При ошибке записи файл будет переоткрыт перед следующей записью
+    if (!m_logfile.good()) {
+        m_reopenRequested.store(true, std::memory_order_relaxed);
+    }
+}
+
 }
 
 #endif // COMPONENTS_IS_ENABLED_QT
@@ -3,6 +3,8 @@
 #ifndef COMPONENTS_IS_ENABLED_QT
 
 #include <fstream>
+#include <vector>
+#include <atomic>
 
 #include "../common.hpp"
 #include "../filewriterbase.hpp"
@@ -14,37 +16,60 @@ using namespace Logger;
 
 class FileWriter final : public FileWriterBase
 {
-    template <typename T>
-    void writeToFile(const T& v) {
-        m_logfile << v << " ";
-    }
 public:
-    using FileWriterBase::FileWriterBase;
+    /**
+     * @brief The OpenMode enum Режим работы с логфайлом
+     */
+    enum class OpenMode {
+        Persistent, //! Файл открывается один раз, запись буферизуется в памяти процесса
+        Reopen,     //! Файл открывается и закрывается на каждую запись
+    };
+
+    FileWriter();
+    ~FileWriter();
+
+    void setLogfile(const std::string& filePath) override;
+    void setLogfile(const std::string_view& filePath) override;
+
+    /**
+     * @brief setOpenMode   Задать режим работы с логфайлом
+     * @param mode          Режим. По умолчанию OpenMode::Persistent
+     */
+    void setOpenMode(OpenMode mode);
+    OpenMode getOpenMode() const;
+
+    /**
+     * @brief reopen Переоткрыть логфайл (например, после ротации внешней утилитой)
+     */
+    void reopen();
+
+    /**
+     * @brief requestReopen Запросить переоткрытие логфайла перед следующей записью
+     * @note                Безопасно для вызова из обработчика сигнала (SIGHUP)
+     */
+    void requestReopen();
 
     /**
-    * @brief log Вывести данные в потоке логгирования. Для синхронного вывода
-    * укажите isSync как true
-    * @param args Данные на вывод
-    */
-    template<Level lt, typename... Args>
-    void log(Args&&... args) {
-        lockFile();
-        m_logfile.open(getLogfilePath().data(), std::ios_base::out | std::ios_base::app);
-        if (!m_logfile.is_open()) {
-            throw std::runtime_error(
-                        std::string("Error opening logfile (logfile path: ") +
-                        getLogfilePath().data() + ")");
-        }
-        (writeToFile(args), ...);
-        m_logfile << std::endl;
-
-        m_logfile.flush();
-        m_logfile.close();
-        unlockFile();
-    }
+     * @brief flush Сбросить буферизованные данные в файл
+     */
+    void flush();
+
+    /**
+     * @brief write Записать в файл отформатированный текст (например, пакет записей)
+     * @param data  Текст
+     * @param size  Размер текста
+     */
+    void write(const char* data, std::size_t size);
 
 private:
-    std::fstream m_logfile;
+    std::ofstream       m_logfile;
+    std::vector<char>   m_logfileBuffer;                    //! Буфер записи в пространстве процесса
+    OpenMode            m_openMode {OpenMode::Persistent};
+    std::atomic<bool>   m_reopenRequested {false};
+
+    bool openLogfile();
+    bool prepareLogfile();
+    void finishRecord();
 };
 
 }
@@ -0,0 +1,190 @@
+#include "jsonlinessink.hpp"
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+
+#include <cmath>
+#include <type_traits>
+
+namespace LoggerNoQt
+{
+
+/**
+ * @brief appendJsonString  Добавить строку JSON в кавычках. Участки без спецсимволов копируются целиком
+ */
+static void appendJsonString(TextBuffer& buffer, std::string_view text)
+{
+    static constexpr char HEX_DIGITS[] {"0123456789abcdef"};
+
+    buffer.append('"');
+    std::size_t runBegin {0};
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(text[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+
+        buffer.append(text.data() + runBegin, i - runBegin);
+        runBegin = i + 1;
+        switch (ch) {
+            case '"':
+                buffer.append(std::string_view("\\\""));
+                break;
+            case '\\':
+                buffer.append(std::string_view("\\\\"));
+                break;
+            case '\n':
+                buffer.append(std::string_view("\\n"));
+                break;
+            case '\r':
+                buffer.append(std::string_view("\\r"));
+                break;
+            case '\t':
+                buffer.append(std::string_view("\\t"));
+                break;
+            default: {
+                const char escaped[] {'\\', 'u', '0', '0', HEX_DIGITS[ch >> 4], HEX_DIGITS[ch & 0xf]};
+                buffer.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+    buffer.append(text.data() + runBegin, text.size() - runBegin);
+    buffer.append('"');
+}
+
+/**
+ * @brief appendJsonValue   Добавить значение поля с сохранением типа
+ */
+template <typename T>
+static void appendJsonValue(TextBuffer& buffer, const T& v)
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        buffer.append(v ? std::string_view("true") : std::string_view("false"));
+    } else if constexpr (std::is_same_v<T, char>) {
+        appendJsonString(buffer, std::string_view(&v, 1));
+    } else if constexpr (std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint64_t>) {
+        buffer.appendNumber(v);
+    } else if constexpr (std::is_same_v<T, double>) {
+        // NaN и бесконечность в JSON не представимы
+        if (std::isfinite(v)) {
+            buffer.appendNumber(v);
+        } else {
+            buffer.append(std::string_view("null"));
+        }
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        appendJsonString(buffer, v);
+    } else {
+        if (v == nullptr) {
+            buffer.append(std::string_view("null"));
+            return;
+        }
+        buffer.append(std::string_view("\"0x"));
+        buffer.appendNumber(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(v)), 16);
+        buffer.append('"');
+    }
+}
+
+JsonLinesSink::JsonLinesSink(const std::string &filePath)
+{
+    m_fileWriter.setLogfile(filePath);
+}
+
+FileWriter &JsonLinesSink::getFilewriter()
+{
+    return m_fileWriter;
+}
+
+void JsonLinesSink::write(const FormattedRecord &record)
+{
+    m_buffer.append('{');
+    if (!record.timestamp.empty()) {
+        m_buffer.append(std::string_view("\"ts\":\""));
+        m_buffer.append(record.timestamp);
+        m_buffer.append(std::string_view("\","));
+    }
+    m_buffer.append(std::string_view("\"level\":\""));
+    m_buffer.append(getLevelName(record.level));
+    m_buffer.append('"');
+    if (record.sampleRate > 1) {
+        m_buffer.append(std::string_view(",\"sample_rate\":"));
+        m_buffer.appendNumber(static_cast<std::uint64_t>(record.sampleRate));
+    }
+    if (record.site != nullptr) {
+        m_buffer.append(std::string_view(",\"file\":"));
+        appendJsonString(m_buffer, record.site->file);
+        m_buffer.append(std::string_view(",\"line\":"));
+        m_buffer.appendNumber(static_cast<std::uint64_t>(record.site->line));
+        if (!record.site->function.empty()) {
+            m_buffer.append(std::string_view(",\"function\":"));
+            appendJsonString(m_buffer, record.site->function);
+        }
+    }
+
+    // Сообщение выводится перед первым полем, разделитель после последнего аргумента отбрасывается
+    m_message.clear();
+    bool isMessageWritten {false};
+    auto writeMessage = [this, &isMessageWritten]() {
+        if (isMessageWritten) {
+            return;
+        }
+        std::string_view message(m_message.data(), m_message.size());
+        while (!message.empty() && (message.back() == ' ' || message.back() == '\n')) {
+            message.remove_suffix(1);
+        }
+        m_buffer.append(std::string_view(",\"msg\":"));
+        appendJsonString(m_buffer, message);
+        isMessageWritten = true;
+    };
+
+    if (record.payload == nullptr) {
+        m_message.append(record.body);
+    }
+    bool isValueExpected {false};
+    record.visitArgs([&](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, FieldKey>) {
+            writeMessage();
+            if (isValueExpected) {
+                m_buffer.append(std::string_view("null"));
+            }
+            m_buffer.append(',');
+            appendJsonString(m_buffer, v.name);
+            m_buffer.append(':');
+            isValueExpected = true;
+        } else if (isValueExpected) {
+            appendJsonValue(m_buffer, v);
+            isValueExpected = false;
+        } else if (!isMessageWritten) {
+            m_message.appendArg(v);
+        }
+    });
+    writeMessage();
+    if (isValueExpected) {
+        m_buffer.append(std::string_view("null"));
+    }
+    m_buffer.append(std::string_view("}\n"));
+}
+
+void JsonLinesSink::flush()
+{
+    writeBuffer();
+    m_fileWriter.flush();
+}
+
+void JsonLinesSink::writeBuffer()
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+    try {
+        m_fileWriter.write(m_buffer.data(), m_buffer.size());
+    } catch (...) {
+        m_buffer.clear();
+        throw;
+    }
+    m_buffer.clear();
+}
+
+}
+
+#endif // COMPONENTS_IS_ENABLED_QT
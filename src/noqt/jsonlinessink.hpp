@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+
+#include <string>
+
+#include "../sink.hpp"
+#include "filewriter.hpp"
+
+namespace LoggerNoQt
+{
+
+using namespace Logger;
+
+/**
+ * @brief The JsonLinesSink class Вывод записей в файл по одному JSON-объекту на строку
+ * @note  Строка вида {"ts":"...","level":"Info","file":"...","line":42,"function":"...","msg":"...","status":200}
+ *        (место вызова - для записей макросов COMPLOG_*). Поля структурированных
+ *        записей (COMPLOG_*_KV) выводятся с исходными типами: числа и bool - без кавычек, строки
+ *        экранируются. Объект сериализуется прямо в буфер пакета, без промежуточного представления.
+ *        Аргументы до первого поля составляют "msg" в том же виде, что и в текстовом логфайле
+ */
+class JsonLinesSink final : public Sink
+{
+public:
+    /**
+     * @param filePath  Путь файла. Ротация настраивается через getFilewriter()
+     */
+    explicit JsonLinesSink(const std::string& filePath);
+
+    JsonLinesSink(const JsonLinesSink&) = delete;
+    JsonLinesSink& operator =(const JsonLinesSink&) = delete;
+
+    FileWriter& getFilewriter();
+
+    void write(const FormattedRecord& record) override;
+    void flush() override;
+
+    bool isStructured() const override {
+        return true;
+    }
+
+private:
+    FileWriter m_fileWriter;
+    TextBuffer m_buffer;  //! Пакет строк для вывода в файл
+    TextBuffer m_message; //! Текст "msg" текущей записи
+
+    void writeBuffer();
+};
+
+}
+
+#endif // COMPONENTS_IS_ENABLED_QT
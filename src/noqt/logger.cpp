@@ -2,13 +2,80 @@
 
 #ifndef COMPONENTS_IS_ENABLED_QT
 
+#include <algorithm>
 #include <filesystem>
 
 namespace LoggerNoQt {
 
+
+/**
+ * @brief The LogfileSink class Приёмник текстового логфайла: пакет записей выводится одной операцией записи
+ */
+class Instance::LogfileSink final : public Sink
+{
+public:
+    explicit LogfileSink(Instance& instance) :
+        m_instance {instance}
+    {}
+
+    void write(const FormattedRecord& record) override {
+        if (m_instance.m_rotationSchedule.isBoundaryCrossed(record.time)) {
+            // Записи пакета до границы остаются в прежнем файле
+            writeBuffer();
+            m_instance.openLogfile(record.time);
+        }
+        record.appendTo(m_buffer, false);
+    }
+
+    void flush() override {
+        writeBuffer();
+        m_instance.m_logfileWriter.flush();
+    }
+
+private:
+    Instance& m_instance;
+    TextBuffer m_buffer; //! Пакет записей для вывода в файл
+
+    void writeBuffer() {
+        if (m_buffer.empty()) {
+            return;
+        }
+        try {
+            m_instance.m_logfileWriter.write(m_buffer.data(), m_buffer.size());
+        } catch (...) {
+            m_buffer.clear();
+            throw;
+        }
+        m_buffer.clear();
+    }
+};
+
+Instance::Instance()
+{
+    // Инстанция общего пула не создаёт своих потоков: логфайл выводит поток пула,
+    // консоль - общий поток консоли, чтобы медленный терминал не задерживал пул
+    const auto& sinkWorker = getSharedSinkWorker();
+    // Консоль принадлежит инстанции: указатель без владения. При заполнении буфера записи консоли
+    // отбрасываются, чтобы медленный терминал не задерживал логфайл
+    m_consoleSink = std::make_shared<SinkChannel>(std::shared_ptr<Sink>(std::shared_ptr<Sink>(), &m_consoleWriter),
+                                                  OverflowPolicy::DropNewest,
+                                                  sinkWorker ? SinkChannel::Mode::Pooled : SinkChannel::Mode::Threaded,
+                                                  sinkWorker);
+    m_logfileSink = std::make_shared<SinkChannel>(std::make_shared<LogfileSink>(*this), OverflowPolicy::Block,
+                                                  hasSharedWorker() ? SinkChannel::Mode::Inline : SinkChannel::Mode::Threaded);
+
+    std::lock_guard<std::mutex> lock(m_sinksMx);
+    m_sinks = {m_consoleSink, m_logfileSink};
+    m_sinksVersion.fetch_add(1, std::memory_order_release);
+}
+
 Instance::~Instance()
 {
     deinit();
+    // Буферы приёмников выводятся до удаления консоли и логфайла
+    for (auto& sink : getSinks()) {
+        sink->close();
+    }
 }
 
 FileWriter &Instance::getFilewriter()
@@ -16,9 +83,206 @@ FileWriter &Instance::getFilewriter()
     return m_logfileWriter;
 }
 
+ConsoleWriter &Instance::getConsoleWriter()
+{
+    return m_consoleWriter;
+}
+
+BinaryWriter &Instance::getBinaryWriter()
+{
+    return m_binaryWriter;
+}
+
+void Instance::setOutputFormat(OutputFormat format)
+{
+    m_outputFormat.store(format, std::memory_order_relaxed);
+}
+
+void Instance::setRotationInterval(RotationInterval interval)
+{
+    m_rotationSchedule.setInterval(interval);
+    m_binaryRotationSchedule.setInterval(interval);
+}
+
+SinkChannel &Instance::addSink(std::shared_ptr<Sink> sink, OverflowPolicy policy)
+{
+    auto channel = std::make_shared<SinkChannel>(std::move(sink), policy);
+    std::lock_guard<std::mutex> lock(m_sinksMx);
+    m_sinks.push_back(channel);
+    m_sinksVersion.fetch_add(1, std::memory_order_release);
+    return *channel;
+}
+
+void Instance::removeSink(const std::shared_ptr<Sink> &sink)
+{
+    std::shared_ptr<SinkChannel> channel;
+    {
+        std::lock_guard<std::mutex> lock(m_sinksMx);
+        const auto it = std::find_if(m_sinks.begin(), m_sinks.end(), [&sink](const auto& v) {
+            return v->getSink() == sink;
+        });
+        if (it == m_sinks.end()) {
+            return;
+        }
+        channel = *it;
+        m_sinks.erase(it);
+        m_sinksVersion.fetch_add(1, std::memory_order_release);
+    }
+    // Рабочий поток может держать канал до обновления своей копии, записи в закрытый канал отбрасываются
+    channel->close();
+}
+
+SinkChannel &Instance::getConsoleSink()
+{
+    return *m_consoleSink;
+}
+
+SinkChannel &Instance::getLogfileSink()
+{
+    return *m_logfileSink;
+}
+
 void Instance::init(const std::string &logfileDir)
 {
-    m_logfileWriter.setLogfile(logfileDir + std::filesystem::path::preferred_separator + createLogfileName());
+    m_logfileDir = logfileDir;
+    const auto time = std::chrono::system_clock::now();
+    openLogfile(time);
+    openBinaryLogfile(time);
+}
+
+void Instance::openLogfile(std::chrono::system_clock::time_point time)
+{
+    const std::filesystem::path logfileName = createLogfileName(time);
+    m_logfileWriter.setLogfile(m_logfileDir + std::filesystem::path::preferred_separator + logfileName.string());
+}
+
+void Instance::openBinaryLogfile(std::chrono::system_clock::time_point time)
+{
+    std::filesystem::path logfileName = createLogfileName(time);
+    m_binaryWriter.setLogfile(m_logfileDir + std::filesystem::path::preferred_separator + logfileName.replace_extension(BINARY_LOG_EXTENSION).string());
+}
+
+std::vector<std::shared_ptr<SinkChannel>> Instance::getSinks()
+{
+    std::lock_guard<std::mutex> lock(m_sinksMx);
+    return m_sinks;
+}
+
+void Instance::updateActiveSinks()
+{
+    const auto version = m_sinksVersion.load(std::memory_order_acquire);
+    if (version == m_activeSinksVersion) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_sinksMx);
+    m_activeSinks = m_sinks;
+    m_activeSinksVersion = m_sinksVersion.load(std::memory_order_relaxed);
+}
+
+void Instance::flushOutput()
+{
+    reportSinkDrops();
+    // Пакет передаётся потокам приёмников, вывод в них не ожидается
+    for (auto& sink : m_activeSinks) {
+        sink->commit();
+    }
+    m_binaryWriter.flush();
+}
+
+void Instance::writeRecord(const Record &record)
+{
+    if (m_outputFormat.load(std::memory_order_relaxed) == OutputFormat::Binary) {
+        const auto time = m_recordFormatter.toSystemTime(record);
+        if (m_binaryRotationSchedule.isBoundaryCrossed(time)) {
+            openBinaryLogfile(time);
+        }
+        m_binaryWriter.write(record, time);
+        return;
+    }
+
+    const auto formatted = m_recordFormatter.format(record, isLocationShown());
+    updateActiveSinks();
+    for (auto& sink : m_activeSinks) {
+        if (sink->isEnabled(formatted.level)) {
+            sink->push(formatted);
+        }
+    }
+}
+
+void Instance::reportSinkDrops()
+{
+    for (auto& dropping : m_activeSinks) {
+        const auto dropped = dropping->takeDroppedCount();
+        if (dropped == 0) {
+            continue;
+        }
+        // Сводка выводится остальными приёмниками: заполненный буфер отбросил бы и её
+        Record summary;
+        summary.assign(Level::Warning, dropping == m_consoleSink ? "Console output: dropped" : "Sink output: dropped",
+                       dropped, "records");
+        const auto formatted = m_recordFormatter.format(summary, false);
+        for (auto& sink : m_activeSinks) {
+            if (sink != dropping && sink->isEnabled(formatted.level)) {
+                sink->push(formatted);
+            }
+        }
+    }
+}
+
+void Instance::writeRecordSync(const Record &record)
+{
+    // Форматирование в вызывающем потоке, приёмники блокируются только на время записи
+    thread_local RecordFormatter formatter;
+    if (m_outputFormat.load(std::memory_order_relaxed) == OutputFormat::Binary) {
+        m_binaryWriter.write(record, formatter.toSystemTime(record));
+        m_binaryWriter.flush();
+        return;
+    }
+
+    const auto formatted = formatter.format(record, isLocationShown());
+    thread_local std::vector<std::shared_ptr<SinkChannel>> sinks;
+    {
+        std::lock_guard<std::mutex> lock(m_sinksMx);
+        sinks.assign(m_sinks.begin(), m_sinks.end());
+    }
+    // Ошибка одного приёмника не мешает выводу в остальные, вызывающий получает первую из ошибок
+    std::exception_ptr error;
+    for (auto& sink : sinks) {
+        if (!sink->isEnabled(formatted.level)) {
+            continue;
+        }
+        try {
+            sink->writeSync(formatted);
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    sinks.clear();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool Instance::waitOutputFlushed(std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+    bool isFlushed {true};
+    for (auto& sink : getSinks()) {
+        isFlushed = sink->waitFlushed(deadline) && isFlushed;
+    }
+    return isFlushed;
+}
+
+const char *Instance::getCrashLogfile() const
+{
+    return m_logfileWriter.getSignalSafePath();
+}
+
+void Instance::writeCrashRecords(CrashWriter &writer)
+{
+    // Пакет, выводимый потоком приёмника в момент падения, в отчёт не попадает
+    m_logfileSink->writeCrashRecords(writer);
 }
 
 }  // namespace Logging
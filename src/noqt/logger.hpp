@@ -3,7 +3,17 @@
 
 #include <iostream>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "../instancebase.hpp"
+#include "../binarywriter.hpp"
+#include "../recordformatter.hpp"
+#include "../rotationschedule.hpp"
+#include "../sinkchannel.hpp"
+#include "consolewriter.hpp"
 #include "filewriter.hpp"
 
 namespace LoggerNoQt {
@@ -11,72 +21,94 @@ using namespace Logger;
 
 /**
  * @brief The Instance class Мастер вывода информации (логов). Синглетон
+ * @note  Текстовые записи форматируются один раз и передаются приёмникам (консоль, логфайл,
+ *        пользовательские), каждый из которых выводит их в своём потоке (см. SinkChannel)
  */
 class Instance final : public InstanceBase {
-    template <typename T>
-    void printLog(T&& v) {
-        std::cout << v << " ";
-    }
-
-    template <typename T>
-    void printErr(T&& v) {
-        std::cerr << v << " ";
-    }
-
 public:
+    Instance();
     ~Instance();
 
+    FileWriter& getFilewriter();
+    ConsoleWriter& getConsoleWriter();
+    BinaryWriter& getBinaryWriter();
+
     /**
-     * @brief log Вывести данные в потоке логгирования. Для синхронного вывода
-     * укажите isSync как true
-     * @param args Данные на вывод
+     * @brief setOutputFormat   Задать формат логфайла
+     * @param format            Формат. При OutputFormat::Binary вывод в консоль не выполняется
      */
-    template<Level lt, bool isSync, typename... Args>
-    void log(Args&&... args) {
-        auto task = [=, this]() {
-            auto timestamp = getTimestamp();
-            if constexpr (lt != Level::Empty && lt != Level::Error && lt != Level::Warning) {
-                printLog(timestamp + " [" + createLogtypeColoredString<lt>() + "] ");
-            }
-
-            if constexpr (lt == Level::Error || lt == Level::Warning) {
-                printErr(timestamp + " [" + createLogtypeColoredString<lt>() + "] ");
-                (printErr(args), ...);
-            } else {
-                (printLog(args), ...);
-            }
-
-            if constexpr (lt != Level::Empty) {
-                m_logfileWriter.log<lt>(timestamp + " [" + createLogtypeString<lt>() + "] ", args...);
-            } else {
-                m_logfileWriter.log<lt>(args...);
-            }
-
-            if constexpr (lt == Level::Error || lt == Level::Warning) {
-                std::cerr << std::endl;
-            } else {
-                std::cout << std::endl;
-            }
-        };
-
-        if constexpr (isSync) {
-            addTaskSync(std::move(task));
-        } else {
-            addTask(std::move(task));
-        }
-    }
+    void setOutputFormat(OutputFormat format);
+
+    /**
+     * @brief setRotationInterval   Задать ротацию логфайлов по местному времени
+     * @param interval              Период. Новый файл получает название по createLogfileName()
+     *                              от момента границы. По умолчанию RotationInterval::None
+     */
+    void setRotationInterval(RotationInterval interval);
+
+    /**
+     * @brief addSink   Зарегистрировать приёмник текстовых записей
+     * @param sink      Приёмник
+     * @param policy    Поведение при заполнении буфера приёмника
+     * @return          Канал приёмника (уровень, размер буфера), действителен до removeSink
+     */
+    SinkChannel& addSink(std::shared_ptr<Sink> sink, OverflowPolicy policy = OverflowPolicy::Block);
+
+    /**
+     * @brief removeSink    Вывести буфер приёмника и исключить его из вывода
+     */
+    void removeSink(const std::shared_ptr<Sink>& sink);
+
+    /**
+     * @brief getConsoleSink    Канал вывода в консоль. По умолчанию OverflowPolicy::DropNewest: медленный
+     *                          терминал не задерживает рабочий поток и логфайл, записи сверх буфера консоли
+     *                          отбрасываются, и их количество выводится в логфайл строкой
+     *                          "Console output: dropped N records"
+     */
+    SinkChannel& getConsoleSink();
+
+    /**
+     * @brief getLogfileSink    Канал вывода в текстовый логфайл. По умолчанию OverflowPolicy::Block.
+     *                          Инстанция общего пула выводит логфайл в потоке пула, без буфера канала
+     */
+    SinkChannel& getLogfileSink();
 
-    FileWriter& getFilewriter();
-    
 private:
+    class LogfileSink;
+
     void init(const std::string& logfileDir) override;
+    void flushOutput() override;
+    void writeRecord(const Record& record) override;
+    void writeRecordSync(const Record& record) override;
+    bool waitOutputFlushed(std::optional<std::chrono::steady_clock::time_point> deadline) override;
+    const char* getCrashLogfile() const override;
+    void writeCrashRecords(CrashWriter& writer) override;
+    void openLogfile(std::chrono::system_clock::time_point time);
+    void openBinaryLogfile(std::chrono::system_clock::time_point time);
+    void updateActiveSinks();
+
+    /**
+     * @brief reportSinkDrops   Вывести сводки записей, отброшенных приёмниками с заполненным буфером
+     */
+    void reportSinkDrops();
+    std::vector<std::shared_ptr<SinkChannel>> getSinks();
     FileWriter m_logfileWriter; //! Мастер записи данных в файл
-};
+    ConsoleWriter m_consoleWriter; //! Мастер вывода данных в консоль
+    BinaryWriter m_binaryWriter; //! Мастер записи данных в двоичный файл
+    std::atomic<OutputFormat> m_outputFormat {OutputFormat::Text};
+    RecordFormatter m_recordFormatter; //! Форматирование записи, общее для всех приёмников
+    RotationSchedule m_rotationSchedule; //! Ротация текстового логфайла по времени (поток приёмника логфайла)
+    RotationSchedule m_binaryRotationSchedule; //! Ротация двоичного логфайла по времени (рабочий поток)
+    std::string m_logfileDir; //! Директория логфайлов
 
-template <>
-inline void Instance::printLog(const bool& v) {
-    std::cout << (v ? "true" : "false") << " ";
-}
+    std::mutex m_sinksMx;
+    std::vector<std::shared_ptr<SinkChannel>> m_sinks; //! Зарегистрированные приёмники (под m_sinksMx)
+    std::atomic<std::uint64_t> m_sinksVersion {0}; //! Изменяется при регистрации и удалении приёмников
+    std::vector<std::shared_ptr<SinkChannel>> m_activeSinks; //! Копия m_sinks рабочего потока
+    std::uint64_t m_activeSinksVersion {0};
+    std::shared_ptr<SinkChannel> m_consoleSink;
+    std::shared_ptr<SinkChannel> m_logfileSink;
+};
 
 }
 
@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * @file payload.hpp Файл с определением формата сериализованных аргументов записи лога
+ * @note Формат общий для очереди инстанции и двоичных логфайлов, поэтому не зависит от Qt
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace Logger
+{
+
+/**
+ * @brief The ArgType enum Тип сериализованного аргумента
+ */
+enum class ArgType : std::uint8_t { Bool, Char, Int, UInt, Double, String, Pointer, Key };
+
+/**
+ * @brief The FieldKey struct Имя поля структурированной записи (см. COMPLOG_INFO_KV).
+ *        Сериализуется как строка с типом ArgType::Key перед значением поля
+ */
+struct FieldKey
+{
+    std::string_view name;
+};
+
+/**
+ * @brief readPayloadValue  Прочитать значение из сериализованных данных
+ * @param pos               Позиция чтения, сдвигается на размер значения
+ */
+template <typename T>
+T readPayloadValue(const std::byte*& pos) {
+    T result;
+    std::memcpy(&result, pos, sizeof(T));
+    pos += sizeof(T);
+    return result;
+}
+
+/**
+ * @brief visitPayload  Обойти сериализованные аргументы
+ * @param data          Сериализованные аргументы
+ * @param size          Размер данных
+ * @param visitor       Функтор, принимающий bool, char, std::int64_t, std::uint64_t, double,
+ *                      std::string_view, const void* или FieldKey
+ * @return              false, если данные повреждены
+ */
+template <typename F>
+bool visitPayload(const std::byte* data, std::size_t size, F&& visitor) {
+    auto pos = data;
+    const auto end = data + size;
+    auto isAvailable = [&pos, end](std::size_t bytes) {
+        return static_cast<std::size_t>(end - pos) >= bytes;
+    };
+
+    while (pos < end) {
+        const auto type = static_cast<ArgType>(*pos++);
+        switch (type) {
+        case ArgType::Bool:
+        case ArgType::Char:
+            if (!isAvailable(1)) {
+                return false;
+            }
+            if (type == ArgType::Bool) {
+                visitor(static_cast<bool>(*pos++));
+            } else {
+                visitor(static_cast<char>(*pos++));
+            }
+            break;
+        case ArgType::Int:
+        case ArgType::UInt:
+        case ArgType::Double:
+        case ArgType::Pointer:
+            if (!isAvailable(8)) {
+                return false;
+            }
+            if (type == ArgType::Int) {
+                visitor(readPayloadValue<std::int64_t>(pos));
+            } else if (type == ArgType::UInt) {
+                visitor(readPayloadValue<std::uint64_t>(pos));
+            } else if (type == ArgType::Double) {
+                visitor(readPayloadValue<double>(pos));
+            } else {
+                visitor(reinterpret_cast<const void*>(static_cast<std::uintptr_t>(readPayloadValue<std::uint64_t>(pos))));
+            }
+            break;
+        case ArgType::String:
+        case ArgType::Key: {
+            if (!isAvailable(sizeof(std::uint32_t))) {
+                return false;
+            }
+            const auto length = readPayloadValue<std::uint32_t>(pos);
+            if (!isAvailable(length)) {
+                return false;
+            }
+            const std::string_view text(reinterpret_cast<const char*>(pos), length);
+            if (type == ArgType::String) {
+                visitor(text);
+            } else {
+                visitor(FieldKey {text});
+            }
+            pos += length;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+}
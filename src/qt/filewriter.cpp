@@ -7,9 +7,37 @@ namespace LoggerQt
 
 void FileWriter::setLogfile(const std::string &logfilePath)
 {
+    // Вызывается и рабочим потоком при ротации по времени, пока синхронные записи выводятся в файл
+    lockFile();
+    // QFile не меняет имя открытого файла
+    m_logfile.close();
+    FileWriterBase::setLogfile(logfilePath);
     m_logfile.setFileName(logfilePath.c_str());
     m_logfile.open(QIODevice::Append | QIODevice::Truncate);
-    FileWriterBase::setLogfile(logfilePath);
+    countOpenedSize();
+    unlockFile();
+}
+
+void FileWriter::write(const char *data, std::size_t size)
+{
+    lockFile();
+    if (isRotationNeeded(size)) {
+        m_logfile.close();
+        rotateLogfile();
+        m_logfile.setFileName(getLogfilePath().data());
+        m_logfile.open(QIODevice::Append);
+        countOpenedSize();
+    }
+    if (!m_logfile.isOpen()) {
+        unlockFile();
+        throw std::runtime_error(
+                    std::string("Error opening logfile (logfile path: ") +
+                    getLogfilePath().data() + ")");
+    }
+    m_logfile.write(data, static_cast<qint64>(size));
+    m_logfile.flush();
+    countWrittenSize(size);
+    unlockFile();
 }
 
 }
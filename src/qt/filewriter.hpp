@@ -15,6 +15,7 @@
 
 #include "../common.hpp"
 #include "../filewriterbase.hpp"
+#include "../record.hpp"
 
 #include <iostream>
 
@@ -25,58 +26,59 @@ using namespace Logger;
 
 class FileWriter final : public FileWriterBase
 {
-    QFile m_logfile;                            //! Логфайл
-    QTextStream m_logfileStream{&m_logfile};    //! Поток ввода в файл данных
-
-    template <typename T>
-    void writeToFile(const T& v) {
-        m_logfileStream << v << " ";
-    }
-
-    void addEndline();
+    QFile m_logfile; //! Логфайл
 
 public:
     void setLogfile(const std::string& logfilePath) override;
 
     /**
-    * @brief log Вывести данные в потоке логгирования. Для синхронного вывода
-    * укажите isSync как true
-    * @param args Данные на вывод
-    */
-    template<Level lt, typename... Args>
-    void log(Args&&... args) {
-        lockFile();
-        if (!m_logfile.isOpen()) {
-            throw std::runtime_error(
-                        std::string("Error opening logfile (logfile path: ") +
-                        getLogfilePath().data() + ")");
-        }
-        (writeToFile(args), ...);
-        m_logfileStream << Qt::endl;
-        m_logfile.flush();
-        unlockFile();
-    }
+     * @brief write Записать в файл отформатированный текст (например, пакет записей)
+     * @param data  Текст
+     * @param size  Размер текста
+     */
+    void write(const char* data, std::size_t size);
 };
 
-template <>
-inline void FileWriter::writeToFile(const std::string& v) {
-    m_logfileStream << v.c_str() << " ";
 }
 
+namespace Logger
+{
+
+// Qt-типы сохраняются в записи в виде текста
+
 template <>
-inline void FileWriter::writeToFile(const QVariant& v) {
-    m_logfileStream << "QVariant(" << (v.isNull() ? "NULL" : (v.typeName() + v.toString())) << ")" << " ";
-}
+struct ArgFormatter<QString>
+{
+    static std::string toString(const QString& v) {
+        return v.toStdString();
+    }
+};
 
 template <>
-inline void FileWriter::writeToFile(const QPoint& v) {
-    m_logfileStream << "{" << v.x() << "; " << v.y() << "} ";
-}
+struct ArgFormatter<QVariant>
+{
+    static std::string toString(const QVariant& v) {
+        return "QVariant(" + (v.isNull() ? QString("NULL") : (v.typeName() + v.toString())).toStdString() + ")";
+    }
+};
 
 template <>
-inline void FileWriter::writeToFile(const QPointF& v) {
-    m_logfileStream << "{" << v.x() << "; " << v.y() << "} ";
-}
+struct ArgFormatter<QPoint>
+{
+    static std::string toString(const QPoint& v) {
+        return "{" + std::to_string(v.x()) + "; " + std::to_string(v.y()) + "}";
+    }
+};
+
+template <>
+struct ArgFormatter<QPointF>
+{
+    static std::string toString(const QPointF& v) {
+        QString result;
+        QTextStream(&result) << "{" << v.x() << "; " << v.y() << "}";
+        return result.toStdString();
+    }
+};
 
 }
 
@@ -16,12 +16,120 @@ LoggerQt::FileWriter &LoggerQt::Instance::getFilewriter()
     return m_logfileWriter;
 }
 
+BinaryWriter &Instance::getBinaryWriter()
+{
+    return m_binaryWriter;
+}
+
+void Instance::setOutputFormat(OutputFormat format)
+{
+    m_outputFormat.store(format, std::memory_order_relaxed);
+}
+
+void Instance::setRotationInterval(RotationInterval interval)
+{
+    m_rotationSchedule.setInterval(interval);
+}
+
 void Instance::init(const std::string &logfileDir)
 {
-    m_logfileWriter.setLogfile(logfileDir + QDir::separator().toLatin1() + createLogfileName());
+    m_logfileDir = logfileDir;
+    openLogfiles(std::chrono::system_clock::now());
+}
+
+void Instance::openLogfiles(std::chrono::system_clock::time_point time)
+{
+    // Вызывается рабочим потоком при ротации по времени: писатели меняют файл под своей блокировкой,
+    // синхронные записи других потоков попадают целиком в прежний или в новый файл
+    std::filesystem::path logfileName = createLogfileName(time);
+    m_logfileWriter.setLogfile(m_logfileDir + QDir::separator().toLatin1() + logfileName.string());
+    m_binaryWriter.setLogfile(m_logfileDir + QDir::separator().toLatin1() + logfileName.replace_extension(BINARY_LOG_EXTENSION).string());
+}
+
+void Instance::writeLogfileBuffer()
+{
+    if (m_logfileBuffer.empty()) {
+        return;
+    }
+    try {
+        m_logfileWriter.write(m_logfileBuffer.data(), m_logfileBuffer.size());
+    } catch (...) {
+        m_logfileBuffer.clear();
+        throw;
+    }
+    m_logfileBuffer.clear();
+}
+
+void Instance::flushOutput()
+{
+    // Пакет записей выводится в файл одной операцией записи
+    writeLogfileBuffer();
+
+    m_binaryWriter.flush();
+}
+
+void Instance::writeRecord(const Record &record)
+{
+    if (m_outputFormat.load(std::memory_order_relaxed) == OutputFormat::Binary) {
+        const auto time = m_recordFormatter.toSystemTime(record);
+        if (m_rotationSchedule.isBoundaryCrossed(time)) {
+            openLogfiles(time);
+        }
+        m_binaryWriter.write(record, time);
+        return;
+    }
+
+    const auto formatted = m_recordFormatter.format(record, isLocationShown());
+    if (m_rotationSchedule.isBoundaryCrossed(formatted.time)) {
+        // Записи пакета до границы остаются в прежнем файле
+        writeLogfileBuffer();
+        openLogfiles(formatted.time);
+    }
+
+    // Каждая запись передаётся в qDebug отдельным сообщением для установленных обработчиков
+    m_consoleBuffer.clear();
+    formatted.appendTo(m_consoleBuffer, true);
+    qDebug().noquote() << QString::fromUtf8(m_consoleBuffer.data(), static_cast<int>(m_consoleBuffer.size() - 1));
+
+    formatted.appendTo(m_logfileBuffer, false);
+}
+
+void Instance::writeRecordSync(const Record &record)
+{
+    // Форматирование в вызывающем потоке, приёмники блокируются только на время записи.
+    // Ротация по времени проверяется рабочим потоком
+    thread_local RecordFormatter formatter;
+    if (m_outputFormat.load(std::memory_order_relaxed) == OutputFormat::Binary) {
+        m_binaryWriter.write(record, formatter.toSystemTime(record));
+        m_binaryWriter.flush();
+        return;
+    }
+
+    const auto formatted = formatter.format(record, isLocationShown());
+
+    thread_local TextBuffer buffer;
+    buffer.clear();
+    formatted.appendTo(buffer, true);
+    qDebug().noquote() << QString::fromUtf8(buffer.data(), static_cast<int>(buffer.size() - 1));
+
+    buffer.clear();
+    formatted.appendTo(buffer, false);
+    m_logfileWriter.write(buffer.data(), buffer.size());
+}
+
+const char *Instance::getCrashLogfile() const
+{
+    return m_logfileWriter.getSignalSafePath();
+}
+
+void Instance::writeCrashRecords(CrashWriter &writer)
+{
+#ifdef COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+    // Пакет уже отформатирован в виде логфайла
+    writer.append(m_logfileBuffer.data(), m_logfileBuffer.size());
+#endif // COMPLOG_PRIVATE_HAS_CRASH_HANDLER
 }
 
 }  // namespace Logging
 
 #endif // COMPONENTS_IS_ENABLED_QT
-
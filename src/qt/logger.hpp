@@ -3,7 +3,12 @@
 
 #include <QDebug>
 
+#include <atomic>
+
 #include "../instancebase.hpp"
+#include "../binarywriter.hpp"
+#include "../recordformatter.hpp"
+#include "../rotationschedule.hpp"
 #include "filewriter.hpp"
 
 namespace LoggerQt {
@@ -13,57 +18,46 @@ using namespace Logger;
  * @brief The Instance class Мастер вывода информации (логов). Синглетон
  */
 class Instance : public InstanceBase {
-    template <typename T>
-    void printLog(const T& v, QDebug& dbgStream) {
-        dbgStream << v;
-    }
-
 public:
     ~Instance();
 
+    FileWriter& getFilewriter();
+    BinaryWriter& getBinaryWriter();
+
     /**
-     * @brief log Вывести данные в потоке логгирования. Для синхронного вывода
-     * укажите isSync как true
-     * @param args Данные на вывод
+     * @brief setOutputFormat   Задать формат логфайла
+     * @param format            Формат. При OutputFormat::Binary вывод в консоль не выполняется
      */
-    template<Level lt, bool isSync, typename... Args>
-    void log(Args&&... args) {
-        auto task = [=, this]() {
-            auto timestamp = getTimestamp();
-            auto dbgStream = qDebug();
-            if constexpr (lt != Level::Empty) {
-                printLog(timestamp + " [" + createLogtypeColoredString<lt>() + "] ", dbgStream);
-            }
-            (printLog(args, dbgStream), ...);
-
-            if constexpr (lt != Level::Empty) {
-                m_logfileWriter.log<lt>(timestamp + " [" + createLogtypeString<lt>() + "] ", args...);
-            } else {
-                m_logfileWriter.log<lt>(args...);
-            }
-        };
-
-        if constexpr (isSync) {
-            addTaskSync(std::move(task));
-        } else {
-            addTask(std::move(task));
-        }
-    }
+    void setOutputFormat(OutputFormat format);
 
-    FileWriter& getFilewriter();
+    /**
+     * @brief setRotationInterval   Задать ротацию логфайлов по местному времени
+     * @param interval              Период. Новый файл получает название по createLogfileName()
+     *                              от момента границы. По умолчанию RotationInterval::None
+     */
+    void setRotationInterval(RotationInterval interval);
 
 private:
     FileWriter m_logfileWriter; //! Мастер записи данных в файл
+    BinaryWriter m_binaryWriter; //! Мастер записи данных в двоичный файл
+    std::atomic<OutputFormat> m_outputFormat {OutputFormat::Text};
+    RecordFormatter    m_recordFormatter;    //! Форматирование записи, общее для консоли и файла
+    RotationSchedule   m_rotationSchedule;   //! Ротация логфайлов по времени
+    std::string        m_logfileDir;         //! Директория логфайлов
+    TextBuffer         m_consoleBuffer;      //! Текущая запись для вывода через qDebug
+    TextBuffer         m_logfileBuffer;      //! Пакет записей для вывода в файл
 
     // InstanceBase interface
     void init(const std::string &logfileDir) override;
+    void writeRecord(const Record& record) override;
+    void writeRecordSync(const Record& record) override;
+    void flushOutput() override;
+    const char* getCrashLogfile() const override;
+    void writeCrashRecords(CrashWriter& writer) override;
+    void openLogfiles(std::chrono::system_clock::time_point time);
+    void writeLogfileBuffer();
 };
 
-template <>
-inline void Instance::printLog(const std::string& v, QDebug& dbgStream) {
-    dbgStream << v.c_str();
-}
-
 }
 
 #endif // COMPONENTS_IS_ENABLED_QT
@@ -0,0 +1,157 @@
+#include "record.hpp"
+
+#include <array>
+#include <mutex>
+
+namespace Logger
+{
+
+// Минимальный размер буфера в пуле (степень двойки)
+constexpr std::size_t ARENA_MIN_BLOCK_SHIFT {9};
+
+// Количество классов размеров буферов в пуле: от 512 байт до 16 Мб
+constexpr std::size_t ARENA_CLASSES_COUNT {16};
+
+// Максимальное количество свободных буферов одного класса, хранимых в пуле
+constexpr std::size_t ARENA_MAX_FREE_BLOCKS {64};
+
+/**
+ * @brief The BlockHeader struct Заголовок буфера, расположенный перед данными
+ */
+struct alignas(std::max_align_t) BlockHeader
+{
+    std::size_t  sizeClass;
+    BlockHeader* next;
+};
+
+struct RecordArena::Impl
+{
+    std::mutex poolMx;
+    std::array<BlockHeader*, ARENA_CLASSES_COUNT> freeBlocks {};
+    std::array<std::size_t, ARENA_CLASSES_COUNT>  freeCounts {};
+
+    static std::size_t blockSize(std::size_t sizeClass) {
+        return std::size_t{1} << (sizeClass + ARENA_MIN_BLOCK_SHIFT);
+    }
+
+    static BlockHeader* allocate(std::size_t sizeClass, std::size_t size) {
+        auto header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+        header->sizeClass = sizeClass;
+        header->next = nullptr;
+        return header;
+    }
+};
+
+RecordArena &RecordArena::instance()
+{
+    // Пул намеренно не удаляется: записи могут освобождаться при разрушении статических инстанций
+    static auto arena = new RecordArena;
+    return *arena;
+}
+
+std::byte *RecordArena::acquire(std::size_t size)
+{
+    std::size_t sizeClass {0};
+    while (sizeClass < ARENA_CLASSES_COUNT && Impl::blockSize(sizeClass) < size) {
+        ++sizeClass;
+    }
+
+    // Слишком большие буферы не кэшируются
+    if (sizeClass == ARENA_CLASSES_COUNT) {
+        return reinterpret_cast<std::byte*>(Impl::allocate(sizeClass, size) + 1);
+    }
+
+    BlockHeader* header {nullptr};
+    {
+        std::lock_guard<std::mutex> lock(d->poolMx);
+        header = d->freeBlocks[sizeClass];
+        if (header) {
+            d->freeBlocks[sizeClass] = header->next;
+            --d->freeCounts[sizeClass];
+        }
+    }
+
+    if (!header) {
+        header = Impl::allocate(sizeClass, Impl::blockSize(sizeClass));
+    }
+    return reinterpret_cast<std::byte*>(header + 1);
+}
+
+void RecordArena::release(std::byte *block)
+{
+    auto header = reinterpret_cast<BlockHeader*>(block) - 1;
+    const auto sizeClass = header->sizeClass;
+
+    if (sizeClass < ARENA_CLASSES_COUNT) {
+        std::lock_guard<std::mutex> lock(d->poolMx);
+        if (d->freeCounts[sizeClass] < ARENA_MAX_FREE_BLOCKS) {
+            header->next = d->freeBlocks[sizeClass];
+            d->freeBlocks[sizeClass] = header;
+            ++d->freeCounts[sizeClass];
+            return;
+        }
+    }
+    ::operator delete(header);
+}
+
+RecordArena::RecordArena() :
+    d {new Impl}
+{
+
+}
+
+RecordArena::~RecordArena()
+{
+    for (auto header : d->freeBlocks) {
+        while (header) {
+            auto next = header->next;
+            ::operator delete(header);
+            header = next;
+        }
+    }
+}
+
+
+Record::~Record()
+{
+    clear();
+}
+
+Record::Record(Record &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+Record &Record::operator =(Record &&other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    clear();
+    m_level = other.m_level;
+    m_size = other.m_size;
+    m_sampleRate = other.m_sampleRate;
+    m_ticks = other.m_ticks;
+    m_sequence = other.m_sequence;
+    m_site = other.m_site;
+    if (other.m_external) {
+        m_external = other.m_external;
+        other.m_external = nullptr;
+    } else {
+        std::memcpy(m_payload, other.m_payload, m_size);
+    }
+    other.m_size = 0;
+    return *this;
+}
+
+void Record::clear()
+{
+    if (m_external) {
+        RecordArena::instance().release(m_external);
+        m_external = nullptr;
+    }
+    m_size = 0;
+}
+
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+/**
+ * @file record.hpp Файл с определением записи лога, передаваемой через очередь инстанции
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+#include <QString>
+#include <QTextStream>
+#else
+#include <sstream>
+#endif // COMPONENTS_IS_ENABLED_QT
+
+#include "common.hpp"
+#include "clock.hpp"
+#include "callsite.hpp"
+#include "payload.hpp"
+
+namespace Logger
+{
+
+//! Размер встроенного буфера записи для сериализованных аргументов
+constexpr std::size_t RECORD_PAYLOAD_SIZE {256};
+
+/**
+ * @brief The ArgFormatter struct Преобразование в текст аргументов, не имеющих двоичного представления
+ * @note  Специализируется для пользовательских типов, в том числе перечислений (без специализации
+ *        и operator<< перечисление сохраняется как число). Вызывается в потоке, выполняющем запись в лог
+ */
+template <typename T, typename = void>
+struct ArgFormatter
+{
+    //! Общая реализация через operator<<: специализации этого признака не имеют
+    static constexpr bool isGeneric {true};
+
+    static std::string toString(const T& v) {
+#ifdef COMPONENTS_IS_ENABLED_QT
+        QString result;
+        QTextStream stream(&result);
+        stream << v;
+        stream.flush();
+        return result.toStdString();
+#else
+        std::ostringstream oss;
+        oss << v;
+        return oss.str();
+#endif // COMPONENTS_IS_ENABLED_QT
+    }
+};
+
+#ifdef COMPONENTS_IS_ENABLED_QT
+using ArgStream = QTextStream;
+#else
+using ArgStream = std::ostream;
+#endif // COMPONENTS_IS_ENABLED_QT
+
+/**
+ * @brief The HasStreamOperator struct Для типа объявлен свободный operator<< (встроенный вывод
+ *        целых чисел, в которые неявно приводится перечисление, не учитывается)
+ */
+template <typename T, typename = void>
+struct HasStreamOperator : std::false_type {};
+
+template <typename T>
+struct HasStreamOperator<T, std::void_t<decltype(operator<<(std::declval<ArgStream&>(), std::declval<const T&>()))>> :
+    std::true_type {};
+
+/**
+ * @brief hasCustomFormatter    Для типа задан пользовательский вывод: специализация ArgFormatter или operator<<
+ */
+template <typename T>
+constexpr bool hasCustomFormatter() {
+    if constexpr (requires { ArgFormatter<T>::isGeneric; }) {
+        return HasStreamOperator<T>::value;
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief The RecordArena class Пул буферов для записей, не поместившихся во встроенный буфер
+ */
+class RecordArena
+{
+public:
+    static RecordArena& instance();
+
+    /**
+     * @brief acquire   Получить буфер из пула
+     * @param size      Требуемый размер
+     * @return          Буфер размером не менее size байт
+     */
+    std::byte* acquire(std::size_t size);
+
+    /**
+     * @brief release   Вернуть буфер в пул
+     * @param block     Буфер, полученный через acquire()
+     */
+    void release(std::byte* block);
+
+private:
+    RecordArena();
+    ~RecordArena();
+
+    struct Impl;
+    std::unique_ptr<Impl> d;
+};
+
+/**
+ * @brief The Record class Запись лога: уровень, момент времени и сериализованные аргументы
+ * @note  Аргументы хранятся во встроенном буфере, при его переполнении - в буфере из RecordArena.
+ *        Момент времени фиксируется в тиках Clock и переводится в системное время потоком вывода
+ */
+class Record
+{
+public:
+    Record() = default;
+    ~Record();
+
+    Record(Record&& other) noexcept;
+    Record& operator =(Record&& other) noexcept;
+    Record(const Record&) = delete;
+    Record& operator =(const Record&) = delete;
+
+    /**
+     * @brief assign    Заполнить запись. Выполняется в вызывающем лог потоке
+     * @param level     Уровень записи
+     * @param args      Данные на вывод
+     */
+    template <typename... Args>
+    void assign(Level level, const Args&... args) {
+        assignPrepared(level, nullptr, prepare(args)...);
+    }
+
+    /**
+     * @brief assign    Заполнить запись. Выполняется в вызывающем лог потоке
+     * @param site      Место вызова
+     * @param args      Данные на вывод
+     */
+    template <typename... Args>
+    void assign(const CallSite& site, const Args&... args) {
+        assignPrepared(site.level, &site, prepare(args)...);
+    }
+
+    /**
+     * @brief assignFields  Заполнить структурированную запись. Выполняется в вызывающем лог потоке
+     * @param level         Уровень записи
+     * @param message       Сообщение
+     * @param fields        Имена полей (строки) и значения через одного
+     */
+    template <typename Message, typename... Fields>
+    void assignFields(Level level, const Message& message, const Fields&... fields) {
+        assignFieldsPrepared(level, nullptr, std::index_sequence_for<Fields...> {}, message, std::forward_as_tuple(fields...));
+    }
+
+    /**
+     * @brief assignFields  Заполнить структурированную запись. Выполняется в вызывающем лог потоке
+     * @param site          Место вызова
+     * @param message       Сообщение
+     * @param fields        Имена полей (строки) и значения через одного
+     */
+    template <typename Message, typename... Fields>
+    void assignFields(const CallSite& site, const Message& message, const Fields&... fields) {
+        assignFieldsPrepared(site.level, &site, std::index_sequence_for<Fields...> {}, message, std::forward_as_tuple(fields...));
+    }
+
+    /**
+     * @brief visitArgs Обойти аргументы записи
+     * @param visitor   Функтор, принимающий bool, char, std::int64_t, std::uint64_t, double,
+     *                  std::string_view, const void* или FieldKey (имя следующего за ним поля)
+     */
+    template <typename F>
+    void visitArgs(F&& visitor) const {
+        visitPayload(data(), m_size, std::forward<F>(visitor));
+    }
+
+    /**
+     * @brief payload   Сериализованные аргументы (формат описан в payload.hpp)
+     */
+    const std::byte* payload() const {
+        return data();
+    }
+
+    std::size_t payloadSize() const {
+        return m_size;
+    }
+
+    Level level() const {
+        return m_level;
+    }
+
+    /**
+     * @brief ticks Момент создания записи в тиках Clock
+     */
+    std::uint64_t ticks() const {
+        return m_ticks;
+    }
+
+    /**
+     * @brief site  Место вызова, создавшее запись. nullptr, если не задано
+     */
+    const CallSite* site() const {
+        return m_site;
+    }
+
+    /**
+     * @brief sampleRate    Запись сохранена одна из sampleRate (1 - выборка не применялась)
+     */
+    std::uint32_t sampleRate() const {
+        return m_sampleRate;
+    }
+
+    void setSampleRate(std::uint32_t sampleRate) {
+        m_sampleRate = sampleRate;
+    }
+
+    /**
+     * @brief sequence  Порядковый номер записи в процессе
+     */
+    std::uint64_t sequence() const {
+        return m_sequence;
+    }
+
+    /**
+     * @brief clear Освободить внешний буфер и очистить запись
+     */
+    void clear();
+
+private:
+    Level               m_level {Level::Empty};
+    std::uint32_t       m_size {0};
+    std::uint32_t       m_sampleRate {1};
+    std::uint64_t       m_ticks {0};
+    std::uint64_t       m_sequence {0};
+    const CallSite*     m_site {nullptr};
+    std::byte*          m_external {nullptr};
+    alignas(std::max_align_t) std::byte m_payload[RECORD_PAYLOAD_SIZE];
+
+    std::byte* data() {
+        return m_external ? m_external : m_payload;
+    }
+
+    const std::byte* data() const {
+        return m_external ? m_external : m_payload;
+    }
+
+    template <typename T>
+    static void write(std::byte*& pos, const T& v) {
+        std::memcpy(pos, &v, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    /**
+     * @brief argType   Тип, в котором аргумент сохраняется в записи
+     * @return          Тип аргумента или std::nullopt, если аргумент преобразуется в текст через ArgFormatter
+     */
+    template <typename T>
+    static constexpr std::optional<ArgType> argType() {
+        if constexpr (std::is_same_v<T, bool>) {
+            return ArgType::Bool;
+        } else if constexpr (std::is_same_v<T, FieldKey>) {
+            return ArgType::Key;
+        } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+            return ArgType::Char;
+        } else if constexpr (std::is_null_pointer_v<T>) {
+            return ArgType::Pointer;
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            return ArgType::String;
+        } else if constexpr (std::is_enum_v<T>) {
+            if constexpr (hasCustomFormatter<T>()) {
+                return std::nullopt;
+            } else {
+                return ArgType::Int;
+            }
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            return ArgType::Int;
+        } else if constexpr (std::is_integral_v<T>) {
+            return ArgType::UInt;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return ArgType::Double;
+        } else if constexpr (std::is_pointer_v<T>) {
+            return ArgType::Pointer;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief prepare   Привести аргумент к сохраняемому виду (текст для типов без двоичного представления)
+     */
+    template <typename T>
+    static decltype(auto) prepare(const T& v) {
+        if constexpr (argType<T>().has_value()) {
+            return v;
+        } else {
+            return ArgFormatter<T>::toString(v);
+        }
+    }
+
+    /**
+     * @brief prepareField  Привести к сохраняемому виду элемент index списка "имя поля, значение"
+     */
+    template <std::size_t index, typename T>
+    static decltype(auto) prepareField(const T& v) {
+        if constexpr (index % 2 == 0) {
+            static_assert(std::is_convertible_v<const T&, std::string_view>, "Field name must be a string");
+            return FieldKey {std::string_view(v)};
+        } else {
+            return prepare(v);
+        }
+    }
+
+    template <typename T>
+    static std::string_view toStringView(const T& v) {
+        if constexpr (std::is_same_v<T, FieldKey>) {
+            return v.name;
+        } else if constexpr (std::is_pointer_v<T>) {
+            if (v == nullptr) {
+                return "(null)";
+            }
+            return std::string_view(v);
+        } else {
+            return std::string_view(v);
+        }
+    }
+
+    template <typename T>
+    static std::size_t encodedSize(const T& v) {
+        constexpr auto type = *argType<T>();
+        if constexpr (type == ArgType::Bool || type == ArgType::Char) {
+            return 2;
+        } else if constexpr (type == ArgType::String || type == ArgType::Key) {
+            return 1 + sizeof(std::uint32_t) + toStringView(v).size();
+        } else {
+            return 1 + 8;
+        }
+    }
+
+    template <typename T>
+    static void encode(std::byte*& pos, const T& v) {
+        constexpr auto type = *argType<T>();
+        *pos++ = static_cast<std::byte>(type);
+        if constexpr (type == ArgType::Bool || type == ArgType::Char) {
+            *pos++ = static_cast<std::byte>(v);
+        } else if constexpr (type == ArgType::String || type == ArgType::Key) {
+            const auto str = toStringView(v);
+            write(pos, static_cast<std::uint32_t>(str.size()));
+            std::memcpy(pos, str.data(), str.size());
+            pos += str.size();
+        } else if constexpr (type == ArgType::Int) {
+            write(pos, static_cast<std::int64_t>(v));
+        } else if constexpr (type == ArgType::UInt) {
+            write(pos, static_cast<std::uint64_t>(v));
+        } else if constexpr (type == ArgType::Double) {
+            write(pos, static_cast<double>(v));
+        } else if constexpr (std::is_function_v<std::remove_pointer_t<T>>) {
+            // Указатель на функцию (например, адрес обработчика) не приводится к const void* через static_cast
+            write(pos, reinterpret_cast<std::uintptr_t>(v));
+        } else {
+            write(pos, reinterpret_cast<std::uintptr_t>(static_cast<const void*>(v)));
+        }
+    }
+
+    template <typename... Args>
+    void assignPrepared(Level level, const CallSite* site, const Args&... args) {
+        clear();
+        m_level = level;
+        m_site = site;
+        m_sampleRate = 1;
+        m_ticks = Clock::now();
+        m_sequence = Clock::nextSequence();
+
+        const auto size = (std::size_t{0} + ... + encodedSize(args));
+        m_size = static_cast<std::uint32_t>(size);
+        if (size > RECORD_PAYLOAD_SIZE) {
+            m_external = RecordArena::instance().acquire(size);
+        }
+
+        [[maybe_unused]] auto pos = data();
+        (encode(pos, args), ...);
+    }
+
+    template <std::size_t... indexes, typename Message, typename Fields>
+    void assignFieldsPrepared(Level level, const CallSite* site, std::index_sequence<indexes...>,
+                              const Message& message, const Fields& fields) {
+        static_assert(sizeof...(indexes) % 2 == 0, "Fields must be name-value pairs");
+        assignPrepared(level, site, prepare(message), prepareField<indexes>(std::get<indexes>(fields))...);
+    }
+};
+
+}
@@ -0,0 +1,41 @@
+#include "recordformatter.hpp"
+
+namespace Logger
+{
+
+FormattedRecord RecordFormatter::format(const Record &record, bool withLocation)
+{
+    m_buffer.clear();
+
+    const auto time = toSystemTime(record);
+    std::size_t timestampSize {0};
+    if (record.level() != Level::Empty) {
+        char timestampBuffer[TimestampFormatter::TIMESTAMP_SIZE];
+        timestampSize = m_timestampFormatter.format(time, timestampBuffer);
+        m_buffer.append(timestampBuffer, timestampSize);
+    }
+
+    record.visitArgs([this](const auto& v) {
+        m_buffer.appendArg(v);
+    });
+    if (withLocation && record.site() != nullptr) {
+        // Как у LoggerDecoder --locations
+        m_buffer.append('(');
+        m_buffer.append(std::string_view(record.site()->file));
+        m_buffer.append(':');
+        m_buffer.appendNumber(static_cast<std::uint64_t>(record.site()->line));
+        m_buffer.append(std::string_view(") "));
+    }
+    m_buffer.append('\n');
+
+    const std::string_view text(m_buffer.data(), m_buffer.size());
+    return {record.level(), time, text.substr(0, timestampSize), text.substr(timestampSize), record.sampleRate(),
+            record.site(), record.payload(), record.payloadSize()};
+}
+
+std::chrono::system_clock::time_point RecordFormatter::toSystemTime(const Record &record)
+{
+    return m_clockCalibration.toSystemTime(record.ticks());
+}
+
+}
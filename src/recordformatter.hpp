@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file recordformatter.hpp Файл с определением форматирования записи, общего для всех приёмников
+ */
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#include "record.hpp"
+#include "textbuffer.hpp"
+#include "timestamp.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The FormattedRecord struct Отформатированная запись. Действительна до следующего RecordFormatter::format
+ */
+struct FormattedRecord
+{
+    Level level;                //! Уровень записи
+    std::chrono::system_clock::time_point time; //! Момент создания записи
+    std::string_view timestamp; //! Момент времени. Пустой для Level::Empty
+    std::string_view body;      //! Аргументы через пробел и перевод строки
+    std::uint32_t sampleRate {1}; //! Запись сохранена одна из sampleRate (см. InstanceBase::setSampling)
+    const CallSite* site {nullptr}; //! Место вызова (файл, строка, функция). nullptr, если не задано
+    const std::byte* payload {nullptr}; //! Сериализованные аргументы. Приёмнику передаются, только если Sink::isStructured
+    std::size_t payloadSize {0};
+
+    /**
+     * @brief visitArgs Обойти типизированные аргументы записи (см. Record::visitArgs)
+     */
+    template <typename F>
+    void visitArgs(F&& visitor) const {
+        if (payload != nullptr) {
+            visitPayload(payload, payloadSize, std::forward<F>(visitor));
+        }
+    }
+
+    /**
+     * @brief appendTo  Вывести запись в буфер приёмника
+     * @param buffer    Буфер
+     * @param colored   Выделять уровень цветом
+     */
+    void appendTo(TextBuffer& buffer, bool colored) const {
+        buffer.append(timestamp);
+        buffer.append(getLevelLabel(level, colored));
+        if (sampleRate > 1) {
+            buffer.appendSampleRate(sampleRate);
+        }
+        buffer.append(body);
+    }
+};
+
+/**
+ * @brief The RecordFormatter class Форматирование записи один раз для всех приёмников
+ * @note  Используется одним потоком (рабочим потоком инстанции), выделений памяти в
+ *        установившемся режиме нет
+ */
+class RecordFormatter
+{
+public:
+    /**
+     * @brief format        Отформатировать запись
+     * @param record        Запись
+     * @param withLocation  Добавить после аргументов место вызова "(file:line) " (см. InstanceBase::setShowLocation)
+     * @return              Отформатированная запись, ссылающаяся на внутренний буфер
+     */
+    FormattedRecord format(const Record& record, bool withLocation = false);
+
+    /**
+     * @brief toSystemTime  Перевести момент записи в системное время
+     */
+    std::chrono::system_clock::time_point toSystemTime(const Record& record);
+
+private:
+    TimestampFormatter m_timestampFormatter; //! Форматирование моментов времени записей
+    ClockCalibration   m_clockCalibration;   //! Перевод моментов записей в системное время
+    TextBuffer         m_buffer;             //! Момент времени и аргументы последней записи
+};
+
+}
@@ -0,0 +1,74 @@
+#include "rotationschedule.hpp"
+
+#include <ctime>
+
+namespace Logger
+{
+
+/**
+ * @brief getNextBoundary   Вычисление начала следующего периода по местному времени
+ * @param tp                Момент времени внутри текущего периода
+ * @param interval          Период ротации (не RotationInterval::None)
+ */
+static std::chrono::system_clock::time_point getNextBoundary(std::chrono::system_clock::time_point tp, RotationInterval interval)
+{
+    const auto timeValue = std::chrono::system_clock::to_time_t(tp);
+    std::tm timeParts;
+
+    // Use localtime_s for thread safety (Windows)
+#ifdef _WIN32
+    localtime_s(&timeParts, &timeValue);
+#else
+    // Use localtime_r for thread safety (POSIX)
+    localtime_r(&timeValue, &timeParts);
+#endif
+
+    // mktime нормализует переполненные поля и учитывает переход на летнее время
+    timeParts.tm_sec = 0;
+    timeParts.tm_min = 0;
+    if (interval == RotationInterval::Daily) {
+        timeParts.tm_hour = 0;
+        ++timeParts.tm_mday;
+    } else {
+        ++timeParts.tm_hour;
+    }
+    timeParts.tm_isdst = -1;
+
+    auto boundary = std::chrono::system_clock::from_time_t(std::mktime(&timeParts));
+    // При переводе часов назад следующий час может совпасть с текущим по местному времени
+    if (boundary <= tp) {
+        boundary = tp + std::chrono::hours(1);
+    }
+    return boundary;
+}
+
+void RotationSchedule::setInterval(RotationInterval interval)
+{
+    m_interval.store(interval, std::memory_order_relaxed);
+    // Граница будет пересчитана потоком вывода при следующей проверке
+    m_version.fetch_add(1, std::memory_order_release);
+}
+
+RotationInterval RotationSchedule::getInterval() const
+{
+    return m_interval.load(std::memory_order_relaxed);
+}
+
+bool RotationSchedule::updateBoundary(std::chrono::system_clock::time_point tp, std::int64_t ns)
+{
+    const auto version = m_version.load(std::memory_order_acquire);
+    // Граница пересечена, только если она вычислена по действующему интервалу
+    const bool isCrossed = version == m_appliedVersion && ns >= m_nextBoundaryNs;
+
+    m_appliedVersion = version;
+    const auto interval = m_interval.load(std::memory_order_relaxed);
+    if (interval == RotationInterval::None) {
+        m_nextBoundaryNs = INT64_MAX;
+    } else {
+        m_nextBoundaryNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    getNextBoundary(tp, interval).time_since_epoch()).count();
+    }
+    return isCrossed;
+}
+
+}
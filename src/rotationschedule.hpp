@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file rotationschedule.hpp Файл с определением расписания ротации логфайлов по времени
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Logger
+{
+
+/**
+ * @brief The RotationInterval enum Период ротации логфайлов по местному времени
+ */
+enum class RotationInterval {
+    None,   //! Без ротации по времени
+    Hourly, //! Новый файл в начале каждого часа
+    Daily,  //! Новый файл в начале каждых суток
+};
+
+/**
+ * @brief The RotationSchedule class Проверка пересечения границы периода ротации
+ * @note  Следующая граница вычисляется заранее (через localtime только при её пересечении),
+ *        поэтому проверка записи сводится к сравнению двух чисел. Интервал можно менять
+ *        из любого потока, проверка выполняется только потоком вывода
+ */
+class RotationSchedule
+{
+public:
+    void setInterval(RotationInterval interval);
+    RotationInterval getInterval() const;
+
+    /**
+     * @brief isBoundaryCrossed Проверка пересечения границы периода с момента предыдущей проверки
+     * @param tp                Момент времени записи
+     * @return                  true, если запись должна попасть в новый файл
+     */
+    bool isBoundaryCrossed(std::chrono::system_clock::time_point tp) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+        if (ns < m_nextBoundaryNs && m_version.load(std::memory_order_relaxed) == m_appliedVersion) {
+            return false;
+        }
+        return updateBoundary(tp, ns);
+    }
+
+private:
+    std::atomic<RotationInterval> m_interval {RotationInterval::None};
+    std::atomic<std::uint32_t>    m_version {0};          //! Увеличивается при каждом изменении интервала
+    std::uint32_t                 m_appliedVersion {0};   //! Версия интервала, по которому вычислена граница
+    std::int64_t                  m_nextBoundaryNs {INT64_MAX}; //! Следующая граница, нс от начала эпохи
+
+    bool updateBoundary(std::chrono::system_clock::time_point tp, std::int64_t ns);
+};
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @file sink.hpp Файл с определением интерфейса приёмника отформатированных записей
+ */
+
+#include "recordformatter.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The Sink class Приёмник отформатированных записей (консоль, файл, пользовательский)
+ * @note  Регистрируется в инстанции через addSink и вызывается потоком своего SinkChannel
+ *        (либо вызывающим потоком для синхронных записей), но не более чем одним потоком одновременно
+ */
+class Sink
+{
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief write     Вывести запись. Данные записи действительны только на время вызова
+     * @param record    Отформатированная запись
+     */
+    virtual void write(const FormattedRecord& record) = 0;
+
+    /**
+     * @brief flush Вывести накопленные записи. Вызывается после каждого пакета и синхронной записи
+     */
+    virtual void flush() {}
+
+    /**
+     * @brief isStructured  Приёмнику нужны типизированные аргументы записи (FormattedRecord::visitArgs)
+     * @note                Иначе они не копируются в буфер приёмника. Проверяется при регистрации
+     */
+    virtual bool isStructured() const {
+        return false;
+    }
+};
+
+}
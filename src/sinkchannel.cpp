@@ -0,0 +1,324 @@
+#include "sinkchannel.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace Logger {
+
+// Размер буфера приёмника по умолчанию
+constexpr std::size_t SINK_BUFFER_LIMIT {1024 * 1024};
+
+/**
+ * @brief The EntryHeader struct Заголовок записи в буфере приёмника, за ним следуют timestamp, body
+ *        и, для структурированного приёмника, сериализованные аргументы
+ */
+struct EntryHeader {
+    Level level;
+    std::chrono::system_clock::time_point time;
+    std::uint32_t timestampSize;
+    std::uint32_t bodySize;
+    std::uint32_t sampleRate;
+    std::uint32_t payloadSize;
+    const CallSite* site;
+};
+
+SinkChannel::SinkChannel(std::shared_ptr<Sink> sink, OverflowPolicy policy, Mode mode, std::shared_ptr<WorkerPool> pool) :
+    m_sink {std::move(sink)},
+    m_mode {mode},
+    m_pool {std::move(pool)},
+    m_maxBytes {SINK_BUFFER_LIMIT},
+    m_policy {policy},
+    m_isStructured {m_sink->isStructured()}
+{
+    if (m_mode == Mode::Threaded) {
+        m_thread = std::thread(&SinkChannel::run, this);
+    }
+}
+
+SinkChannel::~SinkChannel()
+{
+    close();
+}
+
+const std::shared_ptr<Sink> &SinkChannel::getSink() const
+{
+    return m_sink;
+}
+
+void SinkChannel::setBufferLimit(std::size_t maxBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mx);
+        m_maxBytes = maxBytes;
+    }
+    m_spaceCV.notify_all();
+}
+
+void SinkChannel::setOverflowPolicy(OverflowPolicy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mx);
+        m_policy = policy;
+    }
+    m_spaceCV.notify_all();
+}
+
+std::uint64_t SinkChannel::getDroppedCount() const
+{
+    return m_droppedCount.load(std::memory_order_relaxed);
+}
+
+std::exception_ptr SinkChannel::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(m_mx);
+    return m_error;
+}
+
+std::uint64_t SinkChannel::takeDroppedCount()
+{
+    const auto dropped = m_droppedCount.load(std::memory_order_relaxed);
+    return dropped - std::exchange(m_reportedDroppedCount, dropped);
+}
+
+void SinkChannel::push(const FormattedRecord &record)
+{
+    if (m_mode == Mode::Inline) {
+        std::lock_guard<std::mutex> sinkLock(m_sinkMx);
+        if (m_isClosing) {
+            return;
+        }
+        try {
+            m_sink->write(record);
+            ++m_uncommittedCount;
+        } catch (...) {
+            countFailed(std::current_exception(), 1);
+        }
+        return;
+    }
+
+    const EntryHeader header {record.level, record.time,
+                              static_cast<std::uint32_t>(record.timestamp.size()),
+                              static_cast<std::uint32_t>(record.body.size()),
+                              record.sampleRate,
+                              static_cast<std::uint32_t>(m_isStructured ? record.payloadSize : 0),
+                              record.site};
+    const auto entrySize = sizeof(header) + header.timestampSize + header.bodySize + header.payloadSize;
+
+    std::unique_lock<std::mutex> lock(m_mx);
+    // Запись больше ограничения принимается в пустой буфер
+    while (!m_isClosing && !m_buffer.empty() && m_buffer.size() + entrySize > m_maxBytes) {
+        const bool isBlocking = m_policy == OverflowPolicy::Block ||
+                                (m_policy == OverflowPolicy::KeepWarnings &&
+                                 getLevelSeverity(record.level) >= getLevelSeverity(Level::Warning));
+        if (!isBlocking) {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeLocked();
+        m_spaceCV.wait(lock);
+    }
+    if (m_isClosing) {
+        return;
+    }
+
+    m_buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_buffer.append(record.timestamp);
+    m_buffer.append(record.body);
+    if (header.payloadSize != 0) {
+        m_buffer.append(reinterpret_cast<const char*>(record.payload), header.payloadSize);
+    }
+    ++m_pushedCount;
+}
+
+void SinkChannel::commit()
+{
+    if (m_mode == Mode::Inline) {
+        std::lock_guard<std::mutex> sinkLock(m_sinkMx);
+        if (m_isClosing) {
+            return;
+        }
+        // Приёмник может накапливать записи до flush: при ошибке теряются все записи пакета
+        try {
+            m_sink->flush();
+        } catch (...) {
+            countFailed(std::current_exception(), m_uncommittedCount);
+        }
+        m_uncommittedCount = 0;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mx);
+    if (!m_buffer.empty()) {
+        wakeLocked();
+    }
+}
+
+void SinkChannel::writeSync(const FormattedRecord &record)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mx);
+        if (m_isClosing) {
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> sinkLock(m_sinkMx);
+    m_sink->write(record);
+    m_sink->flush();
+}
+
+bool SinkChannel::waitFlushed(std::optional<std::chrono::steady_clock::time_point> deadline)
+{
+    std::unique_lock<std::mutex> lock(m_mx);
+    const auto target = m_pushedCount;
+    auto isFlushed = [this, target]() {
+        return m_writtenCount >= target;
+    };
+    if (isFlushed()) {
+        return true;
+    }
+
+    wakeLocked();
+    if (deadline) {
+        return m_flushedCV.wait_until(lock, *deadline, isFlushed);
+    }
+    m_flushedCV.wait(lock, isFlushed);
+    return true;
+}
+
+void SinkChannel::writeCrashRecords(CrashWriter &writer) const
+{
+#ifdef COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+    const auto data = m_buffer.data();
+    const auto size = m_buffer.size();
+    for (std::size_t pos = 0; pos + sizeof(EntryHeader) <= size;) {
+        EntryHeader header;
+        std::memcpy(&header, data + pos, sizeof(header));
+        pos += sizeof(header);
+        const auto entrySize = std::size_t {header.timestampSize} + header.bodySize + header.payloadSize;
+        if (entrySize > size - pos) {
+            break;
+        }
+        // Как FormattedRecord::appendTo
+        writer.append(data + pos, header.timestampSize);
+        writer.append(getLevelLabel(header.level, false));
+        if (header.sampleRate > 1) {
+            writer.appendSampleRate(header.sampleRate);
+        }
+        writer.append(data + pos + header.timestampSize, header.bodySize);
+        pos += entrySize;
+    }
+#endif // COMPLOG_PRIVATE_HAS_CRASH_HANDLER
+}
+
+void SinkChannel::close()
+{
+    {
+        std::scoped_lock lock(m_mx, m_sinkMx);
+        m_isClosing = true;
+        wakeLocked();
+    }
+    m_spaceCV.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_mode == Mode::Pooled) {
+        // Остаток буфера выводит закрывающий поток
+        m_pool->detach(*this);
+        std::unique_lock<std::mutex> lock(m_mx);
+        while (!m_buffer.empty()) {
+            writeBuffer(lock);
+        }
+    }
+}
+
+void SinkChannel::wakeLocked()
+{
+    m_isCommitted = true;
+    if (m_mode != Mode::Pooled) {
+        m_readyCV.notify_one();
+    } else if (!m_buffer.empty()) {
+        m_hasPendingBatch.store(true, std::memory_order_seq_cst);
+        m_pool->schedule(*this);
+    }
+}
+
+void SinkChannel::countFailed(std::exception_ptr error, std::uint64_t count)
+{
+    m_droppedCount.fetch_add(count, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mx);
+    m_error = std::move(error);
+}
+
+void SinkChannel::runSlice()
+{
+    std::unique_lock<std::mutex> lock(m_mx);
+    m_hasPendingBatch.store(false, std::memory_order_seq_cst);
+    if (!m_buffer.empty()) {
+        writeBuffer(lock);
+    }
+}
+
+bool SinkChannel::hasPendingWork() const
+{
+    return m_hasPendingBatch.load(std::memory_order_seq_cst);
+}
+
+void SinkChannel::run()
+{
+    std::unique_lock<std::mutex> lock(m_mx);
+    for (;;) {
+        m_readyCV.wait(lock, [this]() {
+            return m_isClosing || (m_isCommitted && !m_buffer.empty());
+        });
+        if (m_buffer.empty()) {
+            break;
+        }
+        writeBuffer(lock);
+    }
+}
+
+void SinkChannel::writeBuffer(std::unique_lock<std::mutex> &lock)
+{
+    m_batch.swap(m_buffer);
+    m_isCommitted = false;
+    const auto batchEnd = m_pushedCount;
+    lock.unlock();
+    m_spaceCV.notify_all();
+
+    {
+        std::lock_guard<std::mutex> sinkLock(m_sinkMx);
+        // Записи, на которых приёмник бросил исключение, отбрасываются, остальные выводятся
+        std::uint64_t writtenSize {0};
+        for (std::size_t pos = 0; pos < m_batch.size();) {
+            EntryHeader header;
+            std::memcpy(&header, m_batch.data() + pos, sizeof(header));
+            pos += sizeof(header);
+            const std::string_view timestamp {m_batch.data() + pos, header.timestampSize};
+            pos += header.timestampSize;
+            const std::string_view body {m_batch.data() + pos, header.bodySize};
+            pos += header.bodySize;
+            const auto payload = reinterpret_cast<const std::byte*>(m_batch.data() + pos);
+            pos += header.payloadSize;
+            try {
+                m_sink->write(FormattedRecord {header.level, header.time, timestamp, body, header.sampleRate, header.site,
+                                               header.payloadSize != 0 ? payload : nullptr, header.payloadSize});
+                ++writtenSize;
+            } catch (...) {
+                countFailed(std::current_exception(), 1);
+            }
+        }
+        // Приёмник может накапливать записи до flush: при его ошибке потеряны все записи пакета
+        try {
+            m_sink->flush();
+        } catch (...) {
+            countFailed(std::current_exception(), writtenSize);
+        }
+    }
+    m_batch.clear();
+
+    lock.lock();
+    m_writtenCount = batchEnd;
+    m_flushedCV.notify_all();
+}
+
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+/**
+ * @file sinkchannel.hpp Файл с определением очереди и потока вывода отдельного приёмника
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "instancebase.hpp"
+#include "sink.hpp"
+#include "workerpool.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The SinkChannel class Ограниченный буфер и собственный поток вывода одного приёмника
+ * @note  Рабочий поток инстанции копирует в буфер отформатированные записи (push) и на границе
+ *        пакета передаёт их потоку приёмника (commit). Медленный приёмник заполняет только свой
+ *        буфер и не задерживает остальные, пока действует его OverflowPolicy
+ */
+class SinkChannel : private WorkerPool::Task
+{
+public:
+    /**
+     * @brief The Mode enum Способ вывода в приёмник
+     */
+    enum class Mode {
+        Threaded, //! Собственный поток приёмника
+        Inline,   //! Вывод в рабочем потоке инстанции при push/commit, без буфера (инстанции общего пула)
+        Pooled,   //! Буфер выводит поток пула, общего для нескольких приёмников
+    };
+
+    /**
+     * @brief SinkChannel   Конструктор. Запускает поток приёмника (Mode::Threaded)
+     * @param sink          Приёмник
+     * @param policy        Поведение при заполнении буфера. В Mode::Inline буфера нет, не используется
+     * @param mode          Способ вывода
+     * @param pool          Пул, выводящий буфер в Mode::Pooled
+     */
+    explicit SinkChannel(std::shared_ptr<Sink> sink, OverflowPolicy policy = OverflowPolicy::Block,
+                         Mode mode = Mode::Threaded, std::shared_ptr<WorkerPool> pool = nullptr);
+    ~SinkChannel();
+
+    SinkChannel(const SinkChannel&) = delete;
+    SinkChannel& operator =(const SinkChannel&) = delete;
+
+    const std::shared_ptr<Sink>& getSink() const;
+
+    /**
+     * @brief setLevel  Задать минимальный уровень записей приёмника
+     * @param level     Уровень. Записи с меньшей важностью (см. getLevelSeverity) приёмнику не передаются
+     */
+    void setLevel(Level level) {
+        m_minSeverity.store(getLevelSeverity(level), std::memory_order_relaxed);
+    }
+
+    bool isEnabled(Level level) const {
+        return getLevelSeverity(level) >= m_minSeverity.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief setBufferLimit    Ограничить буфер приёмника
+     * @param maxBytes          Максимальный размер ещё не выведенных записей (по умолчанию 1 МБ)
+     */
+    void setBufferLimit(std::size_t maxBytes);
+
+    /**
+     * @brief setOverflowPolicy Задать поведение при заполнении буфера
+     * @note                    OverflowPolicy::DropOldest действует как DropNewest: выведенные
+     *                          потоком приёмника данные уже не отбрасываются
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+
+    /**
+     * @brief getDroppedCount   Количество записей, отброшенных из-за заполнения буфера или ошибки приёмника
+     */
+    std::uint64_t getDroppedCount() const;
+
+    /**
+     * @brief getLastError  Последнее исключение приёмника при выводе записей рабочего потока (nullptr - ошибок не было)
+     */
+    std::exception_ptr getLastError() const;
+
+    /**
+     * @brief takeDroppedCount  Количество записей, отброшенных с предыдущего вызова (сводка рабочего потока)
+     */
+    std::uint64_t takeDroppedCount();
+
+    /**
+     * @brief push      Добавить запись в буфер (рабочий поток инстанции)
+     * @note            Не бросает исключений: ошибка приёмника не мешает выводу в остальные приёмники,
+     *                  запись учитывается в getDroppedCount, исключение сохраняется в getLastError
+     */
+    void push(const FormattedRecord& record);
+
+    /**
+     * @brief commit    Передать накопленные записи потоку приёмника (граница пакета). Не бросает исключений
+     */
+    void commit();
+
+    /**
+     * @brief writeSync Вывести запись в вызывающем потоке, минуя буфер
+     * @note            Приёмник блокируется на время записи, в том числе от вывода пакета своим потоком
+     * @throw           Исключение приёмника
+     */
+    void writeSync(const FormattedRecord& record);
+
+    /**
+     * @brief waitFlushed   Дождаться вывода записей, добавленных до вызова
+     * @param deadline      Крайний момент ожидания (std::nullopt - без ограничения)
+     * @return              false, если за отведённое время записи выведены не полностью
+     */
+    bool waitFlushed(std::optional<std::chrono::steady_clock::time_point> deadline);
+
+    /**
+     * @brief writeCrashRecords Вывести записи буфера, ещё не переданные потоку приёмника, в отчёт о падении
+     * @note                    Вызывается из обработчика сигнала без блокировки буфера
+     */
+    void writeCrashRecords(CrashWriter& writer) const;
+
+    /**
+     * @brief close Вывести буфер и завершить поток приёмника. Последующие записи отбрасываются
+     */
+    void close();
+
+private:
+    const std::shared_ptr<Sink> m_sink;
+    std::atomic<int> m_minSeverity {getLevelSeverity(Level::Debug)};
+    std::atomic<std::uint64_t> m_droppedCount {0};
+    std::uint64_t              m_reportedDroppedCount {0}; //! Рабочий поток инстанции (takeDroppedCount)
+
+    const Mode              m_mode;
+    const std::shared_ptr<WorkerPool> m_pool;
+    std::uint64_t           m_uncommittedCount {0}; //! Mode::Inline: записи, переданные приёмнику до его flush
+    std::atomic<bool>       m_hasPendingBatch {false}; //! Mode::Pooled: переданные записи ждут потока пула
+    std::mutex              m_sinkMx;   //! Вывод в приёмник (поток приёмника и синхронные записи)
+
+    mutable std::mutex      m_mx;       //! Буфер и счётчики ниже
+    std::condition_variable m_readyCV;  //! Записи переданы потоку приёмника
+    std::condition_variable m_spaceCV;  //! Буфер освобождён
+    std::condition_variable m_flushedCV;
+    TextBuffer              m_buffer;   //! Записи, ещё не переданные потоку приёмника
+    TextBuffer              m_batch;    //! Выводимый пакет (поток приёмника или поток пула)
+    std::size_t             m_maxBytes;
+    OverflowPolicy          m_policy;
+    const bool              m_isStructured; //! В буфер копируются сериализованные аргументы записей
+    std::uint64_t           m_pushedCount {0};
+    std::uint64_t           m_writtenCount {0};
+    bool                    m_isCommitted {false};
+    bool                    m_isClosing {false}; //! Изменяется под m_mx и m_sinkMx
+    std::exception_ptr      m_error;    //! Последнее исключение приёмника (под m_mx)
+
+    std::thread             m_thread;
+
+    void run();
+    void wakeLocked();
+
+    /**
+     * @brief countFailed   Учесть записи, потерянные из-за исключения приёмника
+     */
+    void countFailed(std::exception_ptr error, std::uint64_t count);
+
+    /**
+     * @brief writeBuffer   Вывести буфер в приёмник. Блокировка m_mx снимается на время вывода
+     */
+    void writeBuffer(std::unique_lock<std::mutex>& lock);
+
+    void runSlice() override;
+    bool hasPendingWork() const override;
+};
+
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file textbuffer.hpp Файл с определением буфера для форматирования пакета записей
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "payload.hpp"
+
+namespace Logger
+{
+
+/**
+ * @brief The TextBuffer class Накопление отформатированного текста пакета записей в непрерывном буфере
+ * @note  Числа форматируются через std::to_chars прямо в буфер, строки копируются без
+ *        промежуточных объектов. После clear() память не освобождается, поэтому
+ *        в установившемся режиме выделений нет
+ */
+class TextBuffer
+{
+public:
+    TextBuffer() = default;
+
+    TextBuffer(const TextBuffer&) = delete;
+    TextBuffer& operator =(const TextBuffer&) = delete;
+
+    void append(const char* data, std::size_t size) {
+        m_data.append(data, size);
+    }
+
+    void append(std::string_view text) {
+        m_data.append(text.data(), text.size());
+    }
+
+    void append(char ch) {
+        m_data.push_back(ch);
+    }
+
+    /**
+     * @brief appendArg Добавить аргумент записи с разделителем
+     * @param v         Значение, полученное из Record::visitArgs
+     * @note            Вывод совпадает с std::ostream с настройками по умолчанию,
+     *                  кроме bool (true/false)
+     */
+    void appendArg(bool v) {
+        append(v ? std::string_view("true ") : std::string_view("false "));
+    }
+
+    void appendArg(char v) {
+        m_data.push_back(v);
+        m_data.push_back(' ');
+    }
+
+    void appendArg(std::int64_t v) {
+        appendChars(v);
+    }
+
+    void appendArg(std::uint64_t v) {
+        appendChars(v);
+    }
+
+    void appendArg(double v) {
+        // Как у std::ostream: %g с точностью 6
+        appendChars(v, std::chars_format::general, 6);
+    }
+
+    void appendArg(std::string_view v) {
+        append(v);
+        m_data.push_back(' ');
+    }
+
+    void appendArg(const void* v) {
+        const auto value = reinterpret_cast<std::uintptr_t>(v);
+        if (value == 0) {
+            append(std::string_view("0 "));
+            return;
+        }
+        append(std::string_view("0x"));
+        appendChars(value, 16);
+    }
+
+    /**
+     * @brief appendArg Добавить имя поля структурированной записи: "name=" перед значением
+     */
+    void appendArg(FieldKey v) {
+        append(v.name);
+        m_data.push_back('=');
+    }
+
+    /**
+     * @brief appendNumber  Добавить число без разделителя
+     * @note                double выводится в кратчайшем виде, по которому значение восстанавливается точно
+     */
+    void appendNumber(std::int64_t v) {
+        appendDigits(v);
+    }
+
+    void appendNumber(std::uint64_t v, int base = 10) {
+        appendDigits(v, base);
+    }
+
+    void appendNumber(double v) {
+        appendDigits(v);
+    }
+
+    /**
+     * @brief appendSampleRate  Добавить метку выборочной записи "(sampled 1/N) " (см. InstanceBase::setSampling)
+     */
+    void appendSampleRate(std::uint32_t sampleRate) {
+        append(std::string_view("(sampled 1/"));
+        appendDigits(sampleRate);
+        append(std::string_view(") "));
+    }
+
+    const char* data() const {
+        return m_data.data();
+    }
+
+    std::size_t size() const {
+        return m_data.size();
+    }
+
+    bool empty() const {
+        return m_data.empty();
+    }
+
+    void clear() {
+        m_data.clear();
+    }
+
+    /**
+     * @brief swap  Обменять содержимое буферов (вместе с выделенной памятью)
+     */
+    void swap(TextBuffer& other) noexcept {
+        m_data.swap(other.m_data);
+    }
+
+private:
+    //! Запас под любое число, выводимое через std::to_chars (double в формате %g и 64-битные целые)
+    static constexpr std::size_t MAX_NUMBER_SIZE = 32;
+
+    std::string m_data;
+
+    template <typename T, typename... FormatArgs>
+    void appendDigits(T v, FormatArgs... formatArgs) {
+        const auto oldSize = m_data.size();
+        m_data.resize(oldSize + MAX_NUMBER_SIZE);
+        const auto result = std::to_chars(m_data.data() + oldSize, m_data.data() + m_data.size(), v, formatArgs...);
+        m_data.resize(result.ec == std::errc() ? static_cast<std::size_t>(result.ptr - m_data.data()) : oldSize);
+    }
+
+    template <typename T, typename... FormatArgs>
+    void appendChars(T v, FormatArgs... formatArgs) {
+        appendDigits(v, formatArgs...);
+        m_data.push_back(' ');
+    }
+};
+
+}
@@ -0,0 +1,116 @@
+#include "timestamp.hpp"
+
+#include <cstring>
+#include <ctime>
+
+namespace Logger
+{
+
+/**
+ * @brief writeDigits   Записать число с ведущими нулями
+ * @param buffer        Буфер размером не менее width
+ * @param value         Число
+ * @param width         Количество цифр
+ */
+static void writeDigits(char* buffer, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        buffer[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+std::size_t TimestampFormatter::format(std::chrono::system_clock::time_point tp, char *buffer)
+{
+    const auto msTotal = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    auto second = msTotal / 1000;
+    auto ms = msTotal % 1000;
+    if (ms < 0) {
+        ms += 1000;
+        --second;
+    }
+
+    if (second != m_cachedSecond) {
+        updatePrefix(second);
+    }
+
+    std::memcpy(buffer, m_cachedPrefix, PREFIX_SIZE);
+    writeDigits(buffer + PREFIX_SIZE, static_cast<unsigned>(ms), 3);
+    return TIMESTAMP_SIZE;
+}
+
+std::size_t TimestampFormatter::formatAtOffset(std::chrono::system_clock::time_point tp, std::int64_t utcOffset,
+                                              char *buffer)
+{
+    const auto msTotal = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count() +
+                         utcOffset * 1000;
+    auto second = msTotal / 1000;
+    auto ms = msTotal % 1000;
+    if (ms < 0) {
+        ms += 1000;
+        --second;
+    }
+    auto days = second / 86400;
+    auto daySecond = second % 86400;
+    if (daySecond < 0) {
+        daySecond += 86400;
+        --days;
+    }
+
+    // Дата по количеству дней от 1970-01-01 (алгоритм civil_from_days Г. Хиннанта)
+    days += 719468;
+    const auto era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto dayOfEra = days - era * 146097;
+    const auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const auto monthIndex = (5 * dayOfYear + 2) / 153;
+    const auto day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    const auto month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    const auto year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    writeDigits(buffer, static_cast<unsigned>(year), 4);
+    buffer[4] = '-';
+    writeDigits(buffer + 5, static_cast<unsigned>(month), 2);
+    buffer[7] = '-';
+    writeDigits(buffer + 8, static_cast<unsigned>(day), 2);
+    buffer[10] = 'T';
+    writeDigits(buffer + 11, static_cast<unsigned>(daySecond / 3600), 2);
+    buffer[13] = ':';
+    writeDigits(buffer + 14, static_cast<unsigned>(daySecond / 60 % 60), 2);
+    buffer[16] = ':';
+    writeDigits(buffer + 17, static_cast<unsigned>(daySecond % 60), 2);
+    buffer[19] = '.';
+    writeDigits(buffer + PREFIX_SIZE, static_cast<unsigned>(ms), 3);
+    return TIMESTAMP_SIZE;
+}
+
+void TimestampFormatter::updatePrefix(std::int64_t second)
+{
+    const auto timeValue = static_cast<std::time_t>(second);
+    std::tm timeParts;
+
+    // Use localtime_s for thread safety (Windows)
+#ifdef _WIN32
+    localtime_s(&timeParts, &timeValue);
+#else
+    // Use localtime_r for thread safety (POSIX)
+    localtime_r(&timeValue, &timeParts);
+#endif
+
+    auto pos = m_cachedPrefix;
+    writeDigits(pos, static_cast<unsigned>(timeParts.tm_year + 1900), 4);
+    pos[4] = '-';
+    writeDigits(pos + 5, static_cast<unsigned>(timeParts.tm_mon + 1), 2);
+    pos[7] = '-';
+    writeDigits(pos + 8, static_cast<unsigned>(timeParts.tm_mday), 2);
+    pos[10] = 'T';
+    writeDigits(pos + 11, static_cast<unsigned>(timeParts.tm_hour), 2);
+    pos[13] = ':';
+    writeDigits(pos + 14, static_cast<unsigned>(timeParts.tm_min), 2);
+    pos[16] = ':';
+    writeDigits(pos + 17, static_cast<unsigned>(timeParts.tm_sec), 2);
+    pos[19] = '.';
+
+    m_cachedSecond = second;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @file timestamp.hpp Файл с определением форматирования моментов времени для записей лога
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Logger
+{
+
+/**
+ * @brief The TimestampFormatter class Форматирование момента времени в виде 1970-01-01T01:01:01.001
+ * @note  Дата и время кэшируются для текущей секунды, для каждой записи дописываются только миллисекунды.
+ *        Не потокобезопасен: используется одним потоком вывода либо под его блокировкой
+ */
+class TimestampFormatter
+{
+public:
+    //! Длина отформатированного момента времени
+    static constexpr std::size_t TIMESTAMP_SIZE {23};
+
+    /**
+     * @brief format    Отформатировать момент времени. Не выделяет память
+     * @param tp        Момент времени
+     * @param buffer    Буфер размером не менее TIMESTAMP_SIZE
+     * @return          Количество записанных символов
+     */
+    std::size_t format(std::chrono::system_clock::time_point tp, char* buffer);
+
+    /**
+     * @brief formatAtOffset    Отформатировать момент времени с заданным смещением от UTC
+     * @param tp                Момент времени
+     * @param utcOffset         Смещение местного времени от UTC в секундах
+     * @param buffer            Буфер размером не менее TIMESTAMP_SIZE
+     * @return                  Количество записанных символов
+     * @note                    Без обращения к базе часовых поясов: может вызываться из обработчика сигнала
+     */
+    static std::size_t formatAtOffset(std::chrono::system_clock::time_point tp, std::int64_t utcOffset, char* buffer);
+
+private:
+    static constexpr std::size_t PREFIX_SIZE {20}; // 1970-01-01T01:01:01.
+
+    std::int64_t m_cachedSecond {std::numeric_limits<std::int64_t>::min()};
+    char         m_cachedPrefix[PREFIX_SIZE] {};
+
+    void updatePrefix(std::int64_t second);
+};
+
+}
@@ -0,0 +1,95 @@
+#include "workerpool.hpp"
+
+#include <algorithm>
+
+namespace Logger {
+
+WorkerPool::WorkerPool(std::size_t threadsCount)
+{
+    threadsCount = std::max<std::size_t>(threadsCount, 1);
+    m_threads.reserve(threadsCount);
+    for (std::size_t i = 0; i < threadsCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mx);
+        m_isStopping = true;
+    }
+    m_readyCV.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::schedule(Task &task)
+{
+    // Пара к проверке hasPendingWork в run(): производитель добавил работу и видит флаг,
+    // либо поток пула после снятия флага видит работу
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (task.m_isScheduled.load(std::memory_order_seq_cst) ||
+        task.m_isScheduled.exchange(true, std::memory_order_seq_cst)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mx);
+        if (task.m_isDetached) {
+            return;
+        }
+        m_ready.push_back(&task);
+    }
+    m_readyCV.notify_one();
+}
+
+void WorkerPool::detach(Task &task)
+{
+    std::unique_lock<std::mutex> lock(m_mx);
+    task.m_isDetached = true;
+    m_ready.erase(std::remove(m_ready.begin(), m_ready.end(), &task), m_ready.end());
+    m_idleCV.wait(lock, [&task]() {
+        return !task.m_isRunning;
+    });
+}
+
+std::size_t WorkerPool::getThreadsCount() const
+{
+    return m_threads.size();
+}
+
+void WorkerPool::run()
+{
+    std::unique_lock<std::mutex> lock(m_mx);
+    for (;;) {
+        m_readyCV.wait(lock, [this]() {
+            return m_isStopping || !m_ready.empty();
+        });
+        if (m_isStopping) {
+            return;
+        }
+
+        auto* const task = m_ready.front();
+        m_ready.pop_front();
+        task->m_isRunning = true;
+        lock.unlock();
+
+        task->runSlice();
+
+        lock.lock();
+        task->m_isRunning = false;
+        task->m_isScheduled.store(false, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Оставшаяся работа - в конец очереди, после других готовых задач
+        if (!task->m_isDetached && task->hasPendingWork() &&
+            !task->m_isScheduled.exchange(true, std::memory_order_seq_cst)) {
+            m_ready.push_back(task);
+            m_readyCV.notify_one();
+        }
+        m_idleCV.notify_all();
+    }
+}
+
+} // namespace Logger
@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file workerpool.hpp Файл с определением общего пула рабочих потоков для инстанций логгера
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Logger
+{
+
+/**
+ * @brief The WorkerPool class Небольшой пул потоков, выводящих записи нескольких инстанций
+ * @note  Задача (инстанция) обслуживается не более чем одним потоком одновременно, поэтому порядок
+ *        её записей сохраняется. За один проход задача выводит не более одного пакета и встаёт
+ *        в конец очереди готовых задач, так что загруженная инстанция не задерживает остальные
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief The Task class Задача пула
+     */
+    class Task
+    {
+    public:
+        virtual ~Task() = default;
+
+        /**
+         * @brief runSlice  Выполнить часть работы (один пакет). Вызывается потоком пула
+         */
+        virtual void runSlice() = 0;
+
+        /**
+         * @brief hasPendingWork    Проверка наличия работы после runSlice
+         */
+        virtual bool hasPendingWork() const = 0;
+
+    private:
+        friend class WorkerPool;
+        std::atomic<bool> m_isScheduled {false}; //! Задача в очереди готовых или выполняется
+        bool m_isRunning {false};                //! Под m_mx пула
+        bool m_isDetached {false};               //! Под m_mx пула
+    };
+
+    /**
+     * @brief WorkerPool    Конструктор
+     * @param threadsCount  Количество потоков (не менее 1)
+     */
+    explicit WorkerPool(std::size_t threadsCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator =(const WorkerPool&) = delete;
+
+    /**
+     * @brief schedule  Поставить задачу в очередь, если она ещё не поставлена
+     * @note            Вызывается производителями после добавления работы. Без блокировок, если задача
+     *                  уже запланирована
+     */
+    void schedule(Task& task);
+
+    /**
+     * @brief detach    Исключить задачу из пула, дождавшись завершения её текущего прохода
+     * @note            После вызова задача больше не выполняется
+     */
+    void detach(Task& task);
+
+    std::size_t getThreadsCount() const;
+
+private:
+    std::mutex              m_mx;
+    std::condition_variable m_readyCV; //! Появилась готовая задача
+    std::condition_variable m_idleCV;  //! Проход задачи завершён (для detach)
+    std::deque<Task*>       m_ready;
+    std::vector<std::thread> m_threads;
+    bool                    m_isStopping {false};
+
+    void run();
+};
+
+} // namespace Logger
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+thread_local bool isCountingAllocations {false};
+std::atomic<std::size_t> allocationsCount {0};
+
+/**
+ * @brief The AllocationCounter class Подсчёт выделений памяти в текущем потоке на время жизни объекта
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter() {
+        allocationsCount.store(0);
+        isCountingAllocations = true;
+    }
+
+    ~AllocationCounter() {
+        isCountingAllocations = false;
+    }
+
+    std::size_t count() const {
+        return allocationsCount.load();
+    }
+};
+
+}
+
+// Замещение через malloc/free согласовано для всего набора операторов, но GCC сопоставляет только
+// стандартные пары new/delete и предупреждает о free для указателя из operator new
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif // GCC
+
+void* operator new(std::size_t size) {
+    if (isCountingAllocations) {
+        allocationsCount.fetch_add(1);
+    }
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif // GCC
+
+TEST(LoggerAllocations, AsyncLogIsAllocationFree) {
+    const std::string testDirpath {"test_allocations"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        const std::string shortString {"short"};
+        const std::string_view stringView {"view"};
+        const int value {42};
+
+        // Прогрев: первые записи могут инициализировать статические данные
+        inst->log<Logger::Level::Empty, false>("Warm up", shortString, stringView, value, 1.5, true, 'c');
+
+        AllocationCounter counter;
+        for (int i = 0; i < 1000; ++i) {
+            inst->log<Logger::Level::Empty, false>("Record", shortString, stringView, value, i, 1.5, true, 'c');
+        }
+        EXPECT_EQ(counter.count(), 0u) << "Async log call must not allocate";
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerAllocations, OversizedRecordsReuseArena) {
+    auto& arena = Logger::RecordArena::instance();
+    arena.release(arena.acquire(Logger::RECORD_PAYLOAD_SIZE * 4));
+
+    AllocationCounter counter;
+    for (int i = 0; i < 100; ++i) {
+        arena.release(arena.acquire(Logger::RECORD_PAYLOAD_SIZE * 4));
+    }
+    EXPECT_EQ(counter.count(), 0u) << "Arena must reuse released blocks";
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const std::string benchDirpath {"bench"};
+
+/**
+ * @brief countLines Подсчёт строк в файле
+ */
+std::size_t countLines(const std::string& filePath) {
+    std::ifstream reader(filePath);
+    std::size_t result {0};
+    std::string line;
+    while (std::getline(reader, line)) {
+        ++result;
+    }
+    return result;
+}
+
+/**
+ * @brief printResult Вывод результата замера
+ */
+void printResult(const std::string& name, std::size_t count, std::chrono::nanoseconds elapsed) {
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << "[ BENCH    ] " << name << ": "
+              << static_cast<std::size_t>(count / seconds) << " records/sec"
+              << " (" << count << " records, " << seconds << " s)" << std::endl;
+}
+
+/**
+ * @brief The QueueInstance class Инстанция для замера пропускной способности очереди записей
+ */
+class QueueInstance final : public Logger::InstanceBase
+{
+public:
+    ~QueueInstance() {
+        deinit();
+    }
+
+    std::atomic<std::size_t> counter {0};
+
+private:
+    void init(const std::string&) override {}
+    void writeRecord(const Logger::Record&) override {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+class LoggerBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(benchDirpath);
+        std::filesystem::create_directory(benchDirpath);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(benchDirpath);
+    }
+};
+
+}
+
+TEST_F(LoggerBenchmark, TaskQueueContention) {
+    const std::size_t recordsCount {256 * 1024};
+
+    for (std::size_t producersCount = 1; producersCount <= 64; producersCount *= 2) {
+        auto inst = Logger::InstanceBase::createInstance<QueueInstance>({});
+        const auto perProducer = recordsCount / producersCount;
+
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (std::size_t i = 0; i < producersCount; ++i) {
+            producers.emplace_back([&]() {
+                for (std::size_t j = 0; j < perProducer; ++j) {
+                    inst->log<Logger::Level::Info, false>("Benchmark record", j);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        while (inst->counter.load(std::memory_order_relaxed) != perProducer * producersCount) {
+            std::this_thread::yield();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+
+        printResult("Task queue, producers: " + std::to_string(producersCount), perProducer * producersCount, elapsed);
+    }
+}
+
+TEST_F(LoggerBenchmark, FilteredOutCall) {
+    const std::size_t callsCount {10000000};
+    std::size_t evaluationsCount {0};
+
+    COMPLOG_SET_LEVEL(Logger::Level::Error);
+    auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < callsCount; ++i) {
+        COMPLOG_DEBUG("Filtered out record", i, ++evaluationsCount);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    COMPLOG_SET_LEVEL(Logger::Level::Debug);
+
+    EXPECT_EQ(evaluationsCount, 0u);
+    const auto nsPerCall = std::chrono::duration<double, std::nano>(elapsed).count() / callsCount;
+    std::cout << "[ BENCH    ] Filtered out call: " << nsPerCall << " ns/call" << std::endl;
+}
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+TEST_F(LoggerBenchmark, FileWriterOpenModes) {
+    const std::size_t recordsCount {20000};
+
+    auto runMode = [&](LoggerNoQt::FileWriter::OpenMode mode, const std::string& name) {
+        const auto filePath = benchDirpath + "/" + name + ".log";
+
+        std::chrono::nanoseconds elapsed;
+        {
+            LoggerNoQt::FileWriter writer;
+            writer.setOpenMode(mode);
+            writer.setLogfile(filePath);
+
+            // Как приёмник логфайла: запись форматируется в буфер и выводится одной операцией записи
+            Logger::RecordFormatter formatter;
+            Logger::TextBuffer buffer;
+            Logger::Record record;
+
+            auto begin = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < recordsCount; ++i) {
+                record.assign(Logger::Level::Info, "Benchmark record", i, 123.123);
+                buffer.clear();
+                formatter.format(record).appendTo(buffer, false);
+                writer.write(buffer.data(), buffer.size());
+            }
+            writer.flush();
+            elapsed = std::chrono::steady_clock::now() - begin;
+        }
+
+        EXPECT_EQ(countLines(filePath), recordsCount);
+        printResult(std::string("FileWriter ") + name, recordsCount, elapsed);
+        return elapsed;
+    };
+
+    auto reopenTime     = runMode(LoggerNoQt::FileWriter::OpenMode::Reopen,     "reopen");
+    auto persistentTime = runMode(LoggerNoQt::FileWriter::OpenMode::Persistent, "persistent");
+    EXPECT_LT(persistentTime, reopenTime);
+}
+
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+TEST_F(LoggerBenchmark, MappedFileWriter) {
+    const std::size_t recordsCount {200000};
+    const std::string record {"1970-01-01T01:01:01.001 [ INFO ]  Benchmark record 123 123.123 \n"};
+
+    auto runWriter = [&](auto& writer, const std::string& name) {
+        const auto filePath = benchDirpath + "/" + name + ".log";
+        std::filesystem::remove(filePath);
+        writer.setLogfile(filePath);
+
+        auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < recordsCount; ++i) {
+            writer.write(record.data(), record.size());
+        }
+        writer.flush();
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - begin;
+
+        printResult(name, recordsCount, elapsed);
+        return std::make_pair(filePath, elapsed);
+    };
+
+    LoggerNoQt::FileWriter streamWriter;
+    const auto [streamPath, streamTime] = runWriter(streamWriter, "FileWriter stream");
+
+    // Небольшой блок, чтобы запись пересекала границы отображения
+    Logger::MappedFileWriter mappedWriter(1024 * 1024);
+    const auto [mappedPath, mappedTime] = runWriter(mappedWriter, "MappedFileWriter");
+    mappedWriter.close();
+
+    EXPECT_EQ(std::filesystem::file_size(mappedPath), recordsCount * record.size()) << "Mapped file must be truncated to its length";
+    EXPECT_EQ(countLines(mappedPath), recordsCount);
+    EXPECT_EQ(countLines(streamPath), recordsCount);
+}
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
+
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+TEST_F(LoggerBenchmark, AsyncFileWriter) {
+    const std::size_t recordsCount {200000};
+    const std::size_t batchSize {1024};
+
+    // Пакеты как у рабочего потока инстанции: один write и один flush на пакет
+    std::string batch;
+    for (std::size_t i = 0; i < batchSize; ++i) {
+        batch += "1970-01-01T01:01:01.001 [ INFO ]  Benchmark record " + std::to_string(i) + " 123.123 \n";
+    }
+
+    auto runWriter = [&](auto& writer, const std::string& name) {
+        const auto filePath = benchDirpath + "/" + name + ".log";
+        std::filesystem::remove(filePath);
+        writer.setLogfile(filePath);
+
+        auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < recordsCount / batchSize; ++i) {
+            writer.write(batch.data(), batch.size());
+            writer.flush();
+        }
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - begin;
+
+        printResult(name, recordsCount / batchSize * batchSize, elapsed);
+        return filePath;
+    };
+
+    LoggerNoQt::FileWriter streamWriter;
+    runWriter(streamWriter, "FileWriter stream");
+
+    Logger::AsyncFileWriter blockingWriter(Logger::AsyncFileWriter::Backend::Blocking);
+    const auto blockingPath = runWriter(blockingWriter, "AsyncFileWriter blocking");
+    blockingWriter.close();
+
+    Logger::AsyncFileWriter asyncWriter;
+    const auto asyncPath = runWriter(asyncWriter, asyncWriter.isAsync() ? "AsyncFileWriter io_uring" : "AsyncFileWriter fallback");
+    asyncWriter.close();
+
+    const auto expectedSize = recordsCount / batchSize * batch.size();
+    EXPECT_EQ(std::filesystem::file_size(blockingPath), expectedSize);
+    EXPECT_EQ(std::filesystem::file_size(asyncPath), expectedSize);
+
+    std::ifstream asyncReader(asyncPath);
+    const std::string asyncContent {std::istreambuf_iterator<char>(asyncReader), std::istreambuf_iterator<char>()};
+    std::size_t mismatchCount {0};
+    for (std::size_t pos = 0; pos < asyncContent.size(); pos += batch.size()) {
+        mismatchCount += asyncContent.compare(pos, batch.size(), batch) != 0;
+    }
+    EXPECT_EQ(mismatchCount, 0u) << "Batches must be written in order at their own offsets";
+}
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
+#endif // COMPONENTS_IS_ENABLED_QT
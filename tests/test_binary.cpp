@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "../tools/logdecoder.hpp"
+
+namespace
+{
+
+enum class BinaryState { Ready = 7 };
+
+struct BinaryPoint
+{
+    int x;
+    int y;
+};
+
+std::ostream& operator <<(std::ostream& stream, const BinaryPoint& point)
+{
+    return stream << "(" << point.x << ";" << point.y << ")";
+}
+
+static constexpr Logger::CallSite BINARY_SITE {Logger::Level::Info, __FILE__, __LINE__};
+
+// Одинаковые записи всех типов аргументов для текстового и двоичного логфайлов
+void logAllTypes(Logger::Instance& inst)
+{
+    const std::string text {"string"};
+    const int value {42};
+    inst.logAt<Logger::Level::Info, false>(BINARY_SITE, "Numbers", 1, -2, std::numeric_limits<std::uint64_t>::max(),
+                                           std::numeric_limits<std::int64_t>::min(), 1.5, -0.25f);
+    inst.logAt<Logger::Level::Warning, false>(BINARY_SITE, "Text", 'c', true, false, text, std::string_view("view"));
+    inst.logAt<Logger::Level::Error, false>(BINARY_SITE, "Pointers", &value, nullptr);
+    inst.logAt<Logger::Level::Debug, false>(BINARY_SITE, "Custom", BinaryState::Ready, BinaryPoint {1, 2});
+    inst.logKvAt<Logger::Level::Info, false>(BINARY_SITE, "Request done", "status", 200, "elapsed_ms", 12.5);
+    inst.logAt<Logger::Level::Info, false>(BINARY_SITE);
+}
+
+std::string readFile(const std::string& filePath)
+{
+    std::ifstream reader(filePath, std::ios_base::binary);
+    return {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+}
+
+// Строки лога без отметок времени (у записей разных инстанций они различаются)
+std::string stripTimestamps(const std::string& text)
+{
+    std::istringstream lines(text);
+    std::string result;
+    for (std::string line; std::getline(lines, line);) {
+        result += line.substr(std::min(line.size(), Logger::TimestampFormatter::TIMESTAMP_SIZE));
+        result += '\n';
+    }
+    return result;
+}
+
+std::string decode(const std::string& filePath, bool printLocations)
+{
+    auto file = std::fopen(filePath.data(), "rb");
+    std::ostringstream output;
+    LoggerDecoder::Decoder decoder(file, output, printLocations);
+    EXPECT_EQ(decoder.readHeader(), LoggerDecoder::Decoder::Status::Ok);
+    auto status = LoggerDecoder::Decoder::Status::Ok;
+    while (status == LoggerDecoder::Decoder::Status::Ok) {
+        status = decoder.readEntry();
+    }
+    EXPECT_EQ(status, LoggerDecoder::Decoder::Status::EndOfFile);
+    std::fclose(file);
+    return output.str();
+}
+
+}
+
+TEST(LoggerBinary, WritesBinaryLogfile) {
+    const std::string testDirpath {"test_binary"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    std::string binaryLogfilePath;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->setOutputFormat(Logger::OutputFormat::Binary);
+        binaryLogfilePath = inst->getBinaryWriter().getLogfilePath();
+
+        static constexpr Logger::CallSite site {Logger::Level::Info, __FILE__, __LINE__};
+        for (int i = 0; i < 10; ++i) {
+            inst->logAt<Logger::Level::Info, false>(site, "BinaryRecord", i, 1.5, true);
+        }
+        inst->logAt<Logger::Level::Info, true>(site, "BinaryRecord", 10, 1.5, true);
+    }
+
+    std::ifstream reader(binaryLogfilePath, std::ios_base::binary);
+    ASSERT_TRUE(reader.is_open()) << "Binary logfile did not created. File path: " << binaryLogfilePath;
+    const std::string content {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+
+    ASSERT_GE(content.size(), sizeof(Logger::BINARY_LOG_MAGIC));
+    EXPECT_EQ(content.compare(0, sizeof(Logger::BINARY_LOG_MAGIC), Logger::BINARY_LOG_MAGIC, sizeof(Logger::BINARY_LOG_MAGIC)), 0);
+
+    std::size_t recordsCount {0};
+    for (auto pos = content.find("BinaryRecord"); pos != std::string::npos; pos = content.find("BinaryRecord", pos + 1)) {
+        ++recordsCount;
+    }
+    EXPECT_EQ(recordsCount, 11u);
+
+    // Описание места вызова записывается один раз
+    EXPECT_EQ(content.find(__FILE__), content.rfind(__FILE__));
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerBinary, DecodesAsTextLogfile) {
+    const std::string testDirpath {"test_binary_decode"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directories(testDirpath + "/text"));
+    ASSERT_TRUE(std::filesystem::create_directories(testDirpath + "/binary"));
+
+    std::string textLogfilePath;
+    std::string binaryLogfilePath;
+    for (bool showLocation : {false, true}) {
+        {
+            auto textInst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath + "/text");
+            textInst->getConsoleSink().setLevel(Logger::Level::Error);
+            textInst->setShowLocation(showLocation);
+            textLogfilePath = textInst->getFilewriter().getLogfilePath();
+            logAllTypes(*textInst);
+
+            auto binaryInst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath + "/binary");
+            binaryInst->setOutputFormat(Logger::OutputFormat::Binary);
+            binaryLogfilePath = binaryInst->getBinaryWriter().getLogfilePath();
+            logAllTypes(*binaryInst);
+        }
+
+        // Вывод LoggerDecoder совпадает с текстовым логфайлом, с ключом -l вместе с местом вызова
+        const auto text = stripTimestamps(readFile(textLogfilePath));
+        EXPECT_NE(text.find("Custom 7 (1;2) "), std::string::npos) << text;
+        EXPECT_EQ(stripTimestamps(decode(binaryLogfilePath, showLocation)), text);
+
+        std::filesystem::remove(textLogfilePath);
+        std::filesystem::remove(binaryLogfilePath);
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerBinary, DecoderFollowsGrowingFile) {
+    const std::string testDirpath {"test_binary_follow"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    std::string binaryLogfilePath;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->setOutputFormat(Logger::OutputFormat::Binary);
+        binaryLogfilePath = inst->getBinaryWriter().getLogfilePath();
+        logAllTypes(*inst);
+    }
+    const auto content = readFile(binaryLogfilePath);
+    const auto expected = decode(binaryLogfilePath, true);
+
+    // Режим -f: запись, дописанная не полностью, читается заново после дописывания файла
+    const std::string followPath {testDirpath + "/follow" + Logger::BINARY_LOG_EXTENSION};
+    const auto cutSize = content.size() - 5;
+    {
+        std::ofstream writer(followPath, std::ios_base::binary);
+        writer.write(content.data(), static_cast<std::streamsize>(cutSize));
+    }
+
+    auto file = std::fopen(followPath.data(), "rb");
+    ASSERT_NE(file, nullptr);
+    std::ostringstream output;
+    LoggerDecoder::Decoder decoder(file, output, true);
+    ASSERT_EQ(decoder.readHeader(), LoggerDecoder::Decoder::Status::Ok);
+    while (decoder.readEntry() == LoggerDecoder::Decoder::Status::Ok) {
+    }
+    EXPECT_NE(output.str(), expected);
+
+    {
+        std::ofstream writer(followPath, std::ios_base::binary | std::ios_base::app);
+        writer.write(content.data() + cutSize, static_cast<std::streamsize>(content.size() - cutSize));
+    }
+    auto status = LoggerDecoder::Decoder::Status::Ok;
+    while (status == LoggerDecoder::Decoder::Status::Ok) {
+        status = decoder.readEntry();
+    }
+    EXPECT_EQ(status, LoggerDecoder::Decoder::Status::EndOfFile);
+    EXPECT_EQ(output.str(), expected);
+    std::fclose(file);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerBinary, DecoderRejectsOversizedPayload) {
+    const std::string testDirpath {"test_binary_corrupted"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    // Запись с размером аргументов больше BINARY_MAX_PAYLOAD_SIZE не приводит к выделению памяти под него
+    const std::string filePath {testDirpath + "/corrupted" + Logger::BINARY_LOG_EXTENSION};
+    {
+        std::ofstream writer(filePath, std::ios_base::binary);
+        writer.write(Logger::BINARY_LOG_MAGIC, sizeof(Logger::BINARY_LOG_MAGIC));
+        writer.put(static_cast<char>(Logger::BinaryEntry::Record));
+        const std::string header(Logger::BINARY_RECORD_HEADER_SIZE - sizeof(std::uint32_t), '\0');
+        writer.write(header.data(), static_cast<std::streamsize>(header.size()));
+        const std::uint32_t payloadSize {std::numeric_limits<std::uint32_t>::max()};
+        writer.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+    }
+
+    auto file = std::fopen(filePath.data(), "rb");
+    ASSERT_NE(file, nullptr);
+    std::ostringstream output;
+    LoggerDecoder::Decoder decoder(file, output, false);
+    ASSERT_EQ(decoder.readHeader(), LoggerDecoder::Decoder::Status::Ok);
+    EXPECT_EQ(decoder.readEntry(), LoggerDecoder::Decoder::Status::Corrupted);
+    std::fclose(file);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerBinary, MacrosAcceptEmptyArguments) {
+    // Пустой список аргументов допустим, как и до введения мест вызова
+    auto emptyLog = [] {
+        COMPLOG_EMPTY();
+    };
+    static_cast<void>(emptyLog);
+}
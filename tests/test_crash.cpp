@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#if !defined(COMPONENTS_IS_ENABLED_QT) && (defined(__unix__) || defined(__APPLE__))
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+
+constexpr int PENDING_COUNT {10};
+
+/**
+ * @brief runCrashingChild  Тело дочернего процесса: записи остаются в буфере приёмника логфайла, затем SIGSEGV
+ */
+[[noreturn]] void runCrashingChild(const std::string& dirpath)
+{
+    // Дамп памяти упавшего процесса тесту не нужен
+    const rlimit noCore {0, 0};
+    setrlimit(RLIMIT_CORE, &noCore);
+
+    // Потоки логгера создаются после fork
+    auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(dirpath);
+    inst->getConsoleSink().setLevel(Logger::Level::Error);
+    if (!inst->setCrashHandler(true)) {
+        std::_Exit(2);
+    }
+    inst->log<Logger::Level::Info, false>("Written", 0);
+    inst->flush();
+
+    // Рабочий поток ждёт заполнения пакета и не передаёт записи потоку приёмника
+    inst->setBatching(1024, std::chrono::seconds(30));
+    for (int i = 0; i < PENDING_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Pending", i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::raise(SIGSEGV);
+    std::_Exit(3);
+}
+
+/**
+ * @brief The SlowReportInstance class Инстанция, отчёт о падении которой выводится долго
+ */
+class SlowReportInstance final : public Logger::InstanceBase
+{
+public:
+    explicit SlowReportInstance(std::string crashLogfile) :
+        m_crashLogfile {std::move(crashLogfile)}
+    {}
+
+    ~SlowReportInstance() {
+        deinit();
+    }
+
+private:
+    std::string m_crashLogfile;
+
+    void init(const std::string&) override {}
+    void writeRecord(const Logger::Record&) override {}
+
+    const char* getCrashLogfile() const override {
+        return m_crashLogfile.c_str();
+    }
+
+    void writeCrashRecords(Logger::CrashWriter& writer) override {
+        writer.append(std::string_view("Report begin\n"));
+        writer.flush();
+        // Другой поток падает, пока отчёт не выведен
+        const timespec delay {0, 200'000'000};
+        nanosleep(&delay, nullptr);
+        writer.append(std::string_view("Report end\n"));
+    }
+};
+
+/**
+ * @brief runTwiceCrashingChild Тело дочернего процесса: второй поток получает SIGABRT во время отчёта о SIGSEGV
+ */
+[[noreturn]] void runTwiceCrashingChild(const std::string& crashLogfile)
+{
+    const rlimit noCore {0, 0};
+    setrlimit(RLIMIT_CORE, &noCore);
+
+    auto inst = std::make_shared<SlowReportInstance>(crashLogfile);
+    if (!inst->setCrashHandler(true)) {
+        std::_Exit(2);
+    }
+    std::thread([] {
+        while (!Logger::CrashHandler::isCrashing()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::raise(SIGABRT);
+    }).detach();
+    std::raise(SIGSEGV);
+    std::_Exit(3);
+}
+
+}
+
+TEST(LoggerCrash, PendingRecordsReachLogfile) {
+    const std::string testDirpath {"test_crash"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    const auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        runCrashingChild(testDirpath);
+    }
+
+    int status {0};
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status)) << "exit code " << WEXITSTATUS(status);
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+
+    std::string text;
+    for (const auto& entry : std::filesystem::directory_iterator(testDirpath)) {
+        if (entry.path().extension() == ".log") {
+            std::ifstream reader(entry.path());
+            text.assign(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>());
+        }
+    }
+    EXPECT_NE(text.find(" [ INFO ]  Written 0 \n"), std::string::npos) << text;
+    std::size_t pos {0};
+    for (int i = 0; i < PENDING_COUNT; ++i) {
+        const auto record = " [ INFO ]  Pending " + std::to_string(i) + " \n";
+        pos = text.find(record, pos);
+        ASSERT_NE(pos, std::string::npos) << record << text;
+    }
+    // Отчёт о сигнале и стек вызовов - после последней записи
+    const auto fatalPos = text.find(" [ FAIL ]  Fatal signal " + std::to_string(SIGSEGV) + " (SIGSEGV), backtrace:\n");
+    ASSERT_NE(fatalPos, std::string::npos) << text;
+    EXPECT_GT(fatalPos, pos);
+    EXPECT_GT(text.size(), text.find('\n', fatalPos) + 1);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerCrash, SecondCrashWaitsForReport) {
+    const std::string testDirpath {"test_crash"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+    const std::string crashLogfile {testDirpath + "/crash.log"};
+
+    const auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        runTwiceCrashingChild(crashLogfile);
+    }
+
+    // Процесс завершает сигнал потока, выводившего отчёт, после всего отчёта
+    int status {0};
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status)) << "exit code " << WEXITSTATUS(status);
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+
+    std::ifstream reader(crashLogfile);
+    const std::string text {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+    EXPECT_NE(text.find("Report begin\nReport end\n"), std::string::npos) << text;
+    EXPECT_NE(text.find(" [ FAIL ]  Fatal signal " + std::to_string(SIGSEGV) + " (SIGSEGV), backtrace:\n"),
+              std::string::npos) << text;
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+#endif // !COMPONENTS_IS_ENABLED_QT && (__unix__ || __APPLE__)
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+// Порог задаётся для единицы трансляции до подключения логгера
+#undef COMPLOG_MIN_LEVEL
+#define COMPLOG_MIN_LEVEL Warning
+#include <Components/Logger/Logger.h>
+
+static_assert(!Logger::isLevelEnabled<Logger::Level::Debug,   Logger::Level::COMPLOG_MIN_LEVEL>());
+static_assert(!Logger::isLevelEnabled<Logger::Level::Info,    Logger::Level::COMPLOG_MIN_LEVEL>());
+static_assert(!Logger::isLevelEnabled<Logger::Level::Ok,      Logger::Level::COMPLOG_MIN_LEVEL>());
+static_assert(!Logger::isLevelEnabled<Logger::Level::Empty,   Logger::Level::COMPLOG_MIN_LEVEL>());
+static_assert( Logger::isLevelEnabled<Logger::Level::Warning, Logger::Level::COMPLOG_MIN_LEVEL>());
+static_assert( Logger::isLevelEnabled<Logger::Level::Error,   Logger::Level::COMPLOG_MIN_LEVEL>());
+
+TEST(LoggerMinLevel, DisabledLevelsHaveNoSideEffects) {
+    int evaluationsCount {0};
+    auto sideEffect = [&evaluationsCount]() {
+        return ++evaluationsCount;
+    };
+
+    COMPLOG_EMPTY       ("Disabled", sideEffect());
+    COMPLOG_DEBUG       ("Disabled", sideEffect());
+    COMPLOG_INFO        ("Disabled", sideEffect());
+    COMPLOG_OK          ("Disabled", sideEffect());
+    COMPLOG_SYNC_DEBUG  ("Disabled", sideEffect());
+    COMPLOG_SYNC_INFO   ("Disabled", sideEffect());
+
+    EXPECT_EQ(evaluationsCount, 0) << "Arguments of disabled log calls must not be evaluated";
+}
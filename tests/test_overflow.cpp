@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+namespace
+{
+
+/**
+ * @brief The GatedInstance class Инстанция, рабочий поток которой ждёт открытия шлюза перед выводом записи
+ */
+class GatedInstance final : public Logger::InstanceBase
+{
+public:
+    ~GatedInstance() {
+        isOpen.store(true);
+        deinit();
+    }
+
+    std::atomic<bool> isOpen {false};
+    std::atomic<bool> isFailing {false}; //! Вывод записи после открытия шлюза завершается исключением
+
+    std::vector<std::string> getWritten() {
+        std::lock_guard lock(m_mx);
+        return m_written;
+    }
+
+    /**
+     * @brief waitWritten Дождаться вывода записи, содержащей text
+     */
+    bool waitWritten(const std::string& text) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            const auto written = getWritten();
+            if (std::any_of(written.begin(), written.end(), [&text](const std::string& v) { return v.find(text) != std::string::npos; })) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+private:
+    std::mutex m_mx;
+    std::vector<std::string> m_written;
+
+    void init(const std::string&) override {}
+    void writeRecord(const Logger::Record& record) override {
+        while (!isOpen.load()) {
+            std::this_thread::yield();
+        }
+        if (isFailing.load()) {
+            throw std::runtime_error("Write failed");
+        }
+
+        Logger::TextBuffer buffer;
+        record.visitArgs([&buffer](const auto& v) {
+            buffer.appendArg(v);
+        });
+        std::lock_guard lock(m_mx);
+        m_written.emplace_back(buffer.data(), buffer.size());
+    }
+};
+
+constexpr int RECORDS_COUNT {100};
+
+}
+
+TEST(LoggerOverflow, DropNewest) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->setQueueLimits(8);
+    inst->setOverflowPolicy(Logger::OverflowPolicy::DropNewest);
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Record", i);
+    }
+    const auto dropped = inst->getDroppedCount(Logger::Level::Info);
+    EXPECT_GE(dropped, static_cast<std::uint64_t>(RECORDS_COUNT - 8 - 2));
+    EXPECT_EQ(inst->getDroppedCount(Logger::Level::Warning), 0u);
+
+    inst->isOpen.store(true);
+    ASSERT_TRUE(inst->waitWritten("Log queue overflow: dropped " + std::to_string(dropped))) << "Summary must be written once the queue drains";
+    const auto written = inst->getWritten();
+    EXPECT_EQ(written.size(), RECORDS_COUNT - dropped + 1);
+    EXPECT_EQ(written.front(), "Record 0 ");
+}
+
+TEST(LoggerOverflow, DropOldest) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->setQueueLimits(8);
+    inst->setOverflowPolicy(Logger::OverflowPolicy::DropOldest);
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Debug, false>("Record", i);
+    }
+
+    inst->isOpen.store(true);
+    ASSERT_TRUE(inst->waitWritten("Log queue overflow"));
+    EXPECT_GT(inst->getDroppedCount(Logger::Level::Debug), 0u);
+    EXPECT_TRUE(inst->waitWritten("Record " + std::to_string(RECORDS_COUNT - 1) + " ")) << "Newest record must be kept";
+}
+
+TEST(LoggerOverflow, KeepWarnings) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->setQueueLimits(8);
+    inst->setOverflowPolicy(Logger::OverflowPolicy::KeepWarnings);
+    std::thread opener([&inst]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        inst->isOpen.store(true);
+    });
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Record", i);
+        inst->log<Logger::Level::Warning, false>("Warning", i);
+    }
+    opener.join();
+
+    ASSERT_TRUE(inst->waitWritten("Warning " + std::to_string(RECORDS_COUNT - 1) + " "));
+    EXPECT_GT(inst->getDroppedCount(Logger::Level::Info), 0u);
+    EXPECT_EQ(inst->getDroppedCount(Logger::Level::Warning), 0u);
+    const auto written = inst->getWritten();
+    EXPECT_EQ(std::count_if(written.begin(), written.end(), [](const std::string& v) { return v.rfind("Warning ", 0) == 0; }), RECORDS_COUNT);
+}
+
+TEST(LoggerOverflow, BlockedProducerReleasedOnWriteError) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->setQueueLimits(4);
+    inst->isFailing.store(true);
+
+    auto producer = std::async(std::launch::async, [&inst]() {
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            inst->log<Logger::Level::Info, false>("Blocked", i);
+        }
+    });
+    EXPECT_EQ(producer.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout) << "Queue must be full";
+
+    // Рабочий поток завершается ошибкой: ожидающий производитель не зависает, записи учитываются как отброшенные
+    inst->isOpen.store(true);
+    ASSERT_EQ(producer.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_NO_THROW(producer.get());
+    EXPECT_EQ(inst->getDroppedCount(Logger::Level::Info), static_cast<std::uint64_t>(RECORDS_COUNT - 1));
+    inst->isFailing.store(false);
+}
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+TEST(LoggerOverflow, BlockedProducerSleeps) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->setQueueLimits(4);
+
+    auto getThreadCpuTime = []() {
+        timespec time {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    };
+    auto producer = std::async(std::launch::async, [&]() {
+        const auto begin = getThreadCpuTime();
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            inst->log<Logger::Level::Info, false>("Blocked", i);
+        }
+        return getThreadCpuTime() - begin;
+    });
+
+    // Производитель ждёт места в очереди, не занимая процессор
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    inst->isOpen.store(true);
+    ASSERT_EQ(producer.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_LT(producer.get(), std::chrono::milliseconds(100));
+    EXPECT_TRUE(inst->waitWritten("Blocked " + std::to_string(RECORDS_COUNT - 1)));
+}
+#endif // CLOCK_THREAD_CPUTIME_ID
+
+TEST(LoggerFlush, FlushBarrier) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isOpen.store(true);
+    for (int i = 0; i < RECORDS_COUNT * 10; ++i) {
+        inst->log<Logger::Level::Info, false>("Record", i);
+    }
+    inst->flush();
+    EXPECT_EQ(inst->getWritten().size(), static_cast<std::size_t>(RECORDS_COUNT * 10));
+}
+
+TEST(LoggerFlush, FlushTimeout) {
+    auto inst = std::make_shared<GatedInstance>();
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Record", i);
+    }
+    EXPECT_FALSE(inst->flush(std::chrono::milliseconds(20)));
+
+    inst->isOpen.store(true);
+    EXPECT_TRUE(inst->flush(std::chrono::seconds(5)));
+    EXPECT_EQ(inst->getWritten().size(), static_cast<std::size_t>(RECORDS_COUNT));
+}
+
+TEST(LoggerFlush, ShutdownDeadline) {
+    auto inst = std::make_shared<GatedInstance>();
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Record", i);
+    }
+
+    // Вывод «зависшей» записи завершается уже после истечения времени на остановку
+    std::thread opener([&inst]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        inst->isOpen.store(true);
+    });
+    const auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(inst->shutdown(std::chrono::milliseconds(20)));
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    opener.join();
+
+    const auto dropped = inst->getDroppedCount(Logger::Level::Info);
+    EXPECT_GT(dropped, 0u);
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    EXPECT_TRUE(inst->waitWritten("Log queue overflow: dropped " + std::to_string(dropped)));
+
+    // После остановки записи выводятся синхронно
+    inst->log<Logger::Level::Info, false>("AfterShutdown");
+    EXPECT_TRUE(inst->waitWritten("AfterShutdown"));
+    EXPECT_EQ(inst->getWritten().size(), RECORDS_COUNT - dropped + 2);
+}
+
+TEST(LoggerFlush, WriteErrorDoesNotBlockShutdown) {
+    // Директория логфайлов не задана: вывод в логфайл завершается исключением в рабочем потоке
+    auto inst = Logger::InstanceBase::createInstance<Logger::Instance>({});
+    inst->log<Logger::Level::Info, false>("NoLogfile");
+    inst->flush(std::chrono::seconds(5));
+
+    // Остановка и удаление инстанции не ждут полный таймаут и не зависают на блокировке логфайла
+    const auto start = std::chrono::steady_clock::now();
+    inst->shutdown(std::chrono::seconds(5));
+    inst.reset();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(LoggerStorm, RateLimitPerCallSite) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isOpen.store(true);
+    inst->setRateLimit(10, 5);
+
+    // Локальные места вызова: состояние ограничения не переходит между повторами теста
+    const Logger::CallSite site {Logger::Level::Error, __FILE__, __LINE__};
+    const Logger::CallSite otherSite {Logger::Level::Error, __FILE__, __LINE__};
+    int evaluationsCount {0};
+    for (int i = 0; i < 10000; ++i) {
+        if (inst->isEnabledAt(site)) {
+            inst->logAt<Logger::Level::Error, false>(site, "Storm", ++evaluationsCount);
+        }
+    }
+    // Ограничение одного места вызова не затрагивает другие
+    ASSERT_TRUE(inst->isEnabledAt(otherSite));
+    inst->logAt<Logger::Level::Error, false>(otherSite, "Other");
+    EXPECT_TRUE(inst->waitWritten("Other"));
+    EXPECT_GE(evaluationsCount, 5);
+    EXPECT_LE(evaluationsCount, 7) << "Arguments of suppressed calls must not be evaluated";
+
+    // После паузы маркеры восстановлены, перед записью выводится сводка
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    ASSERT_TRUE(inst->isEnabledAt(site));
+    inst->logAt<Logger::Level::Error, false>(site, "AfterStorm");
+    EXPECT_TRUE(inst->waitWritten("AfterStorm"));
+    EXPECT_TRUE(inst->waitWritten("Rate limit: suppressed " + std::to_string(10000 - evaluationsCount) + " records"));
+}
+
+TEST(LoggerStorm, CollapseRepeated) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isOpen.store(true);
+    inst->setDeduplication(std::chrono::seconds(10));
+
+    const Logger::CallSite site {Logger::Level::Warning, __FILE__, __LINE__};
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->logAt<Logger::Level::Warning, false>(site, "Connection lost", 42);
+    }
+    inst->logAt<Logger::Level::Warning, false>(site, "Connection restored");
+    ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+
+    const auto written = inst->getWritten();
+    ASSERT_EQ(written.size(), 3u);
+    EXPECT_EQ(written[0], "Connection lost 42 ");
+    EXPECT_EQ(written[1], "Last message repeated " + std::to_string(RECORDS_COUNT - 1) + " times ");
+    EXPECT_EQ(written[2], "Connection restored ");
+}
+
+TEST(LoggerStorm, RepeatsReportedWhenStormStops) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isOpen.store(true);
+    inst->setDeduplication(std::chrono::seconds(10));
+
+    // Записей этого места вызова больше нет: повторы выводятся при flush, один раз
+    const Logger::CallSite site {Logger::Level::Warning, __FILE__, __LINE__};
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->logAt<Logger::Level::Warning, false>(site, "Connection lost", 42);
+    }
+    ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+    ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+
+    const auto written = inst->getWritten();
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0], "Connection lost 42 ");
+    EXPECT_EQ(written[1], "Last message repeated " + std::to_string(RECORDS_COUNT - 1) + " times ");
+}
+
+TEST(LoggerFlush, AsyncLogAfterWriteErrorDoesNotThrow) {
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isFailing.store(true);
+    inst->isOpen.store(true);
+    inst->log<Logger::Level::Info, false>("Failed", 0);
+    inst->flush(std::chrono::seconds(5));
+
+    // Асинхронные записи после ошибки рабочего потока не бросают исключений и учитываются как отброшенные
+    for (int i = 1; i <= RECORDS_COUNT; ++i) {
+        EXPECT_NO_THROW((inst->log<Logger::Level::Info, false>("Failed", i)));
+    }
+    EXPECT_EQ(inst->getDroppedCount(Logger::Level::Info), static_cast<std::uint64_t>(RECORDS_COUNT));
+
+    // Сводка выводится один раз, после первой выведенной записи
+    inst->isFailing.store(false);
+    inst->log<Logger::Level::Info, false>("Recovered");
+    inst->log<Logger::Level::Info, false>("Next");
+    const auto written = inst->getWritten();
+    ASSERT_EQ(written.size(), 3u);
+    EXPECT_EQ(written[0], "Recovered ");
+    EXPECT_NE(written[1].find("dropped " + std::to_string(RECORDS_COUNT) + " records"), std::string::npos) << written[1];
+    EXPECT_EQ(written[2], "Next ");
+}
+
+TEST(LoggerFlush, NoRecordLostAroundShutdown) {
+    static constexpr int PRODUCERS_COUNT {4};
+    static constexpr int PRODUCER_RECORDS_COUNT {2000};
+
+    auto inst = std::make_shared<GatedInstance>();
+    inst->isOpen.store(true);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < PRODUCERS_COUNT; ++i) {
+        producers.emplace_back([&inst]() {
+            for (int j = 0; j < PRODUCER_RECORDS_COUNT; ++j) {
+                inst->log<Logger::Level::Info, false>("Racing", j);
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    inst->shutdown(std::chrono::milliseconds(0));
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    // Каждая запись либо выведена (рабочим или вызывающим потоком), либо учтена как отброшенная при остановке
+    const auto written = inst->getWritten();
+    const auto writtenCount = std::count_if(written.begin(), written.end(), [](const std::string& v) {
+        return v.starts_with("Racing");
+    });
+    EXPECT_EQ(static_cast<std::uint64_t>(writtenCount) + inst->getDroppedCount(Logger::Level::Info),
+              static_cast<std::uint64_t>(PRODUCERS_COUNT * PRODUCER_RECORDS_COUNT));
+}
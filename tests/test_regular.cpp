@@ -5,6 +5,38 @@
 #include <fstream>
 #include <filesystem>
 #include <regex>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <thread>
+#include <sstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <iterator>
+#include <string_view>
+#include <algorithm>
+
+namespace
+{
+
+enum class PlainState { Idle = 3 };
+enum class StreamedState { Running };
+enum class FormattedState { Stopped };
+
+std::ostream& operator <<(std::ostream& stream, StreamedState) {
+    return stream << "Running";
+}
+
+}
+
+template <>
+struct Logger::ArgFormatter<FormattedState>
+{
+    static std::string toString(FormattedState) {
+        return "Stopped";
+    }
+};
 
 TEST(LoggerComponent, SetupDirectory) {
     const std::string testDirpath {"test"};
@@ -40,3 +72,309 @@ TEST(LoggerComponent, SetupDirectory) {
 
     std::filesystem::remove_all(testDirpath);
 }
+
+TEST(LoggerComponent, TimestampFormat) {
+    Logger::TimestampFormatter formatter;
+    char buffer[Logger::TimestampFormatter::TIMESTAMP_SIZE];
+
+    const auto base = std::chrono::system_clock::now();
+    for (auto offset : {0, 1, 999, 1000, 1001, 61000, 3600 * 1000}) {
+        const auto tp = base + std::chrono::milliseconds(offset);
+        const std::string formatted(buffer, formatter.format(tp, buffer));
+
+        const auto msTotal = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+        const std::time_t seconds = msTotal / 1000;
+        std::tm timeParts;
+        localtime_r(&seconds, &timeParts);
+        char expected[64];
+        auto expectedSize = std::strftime(expected, sizeof(expected), "%Y-%m-%dT%H:%M:%S", &timeParts);
+        expectedSize += std::snprintf(expected + expectedSize, sizeof(expected) - expectedSize, ".%03d", static_cast<int>(msTotal % 1000));
+
+        ASSERT_EQ(formatted, std::string(expected, expectedSize));
+    }
+}
+
+TEST(LoggerComponent, ClockCalibration) {
+    Logger::ClockCalibration calibration;
+
+    for (int i = 0; i < 3; ++i) {
+        const auto ticks = Logger::Clock::now();
+        const auto expected = std::chrono::system_clock::now();
+        const auto converted = calibration.toSystemTime(ticks);
+
+        const auto error = std::chrono::abs(converted - expected);
+        ASSERT_LT(error, std::chrono::milliseconds(5)) << "Iteration: " << i;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    const auto first = Logger::Clock::nextSequence();
+    ASSERT_LT(first, Logger::Clock::nextSequence());
+}
+
+TEST(LoggerComponent, RuntimeLevel) {
+    auto inst = Logger::InstanceBase::createInstance<Logger::Instance>({});
+    inst->setLevel(Logger::Level::Warning);
+    EXPECT_FALSE(inst->isEnabled(Logger::Level::Debug));
+    EXPECT_FALSE(inst->isEnabled(Logger::Level::Info));
+    EXPECT_TRUE (inst->isEnabled(Logger::Level::Warning));
+    EXPECT_TRUE (inst->isEnabled(Logger::Level::Error));
+
+    int evaluationsCount {0};
+    COMPLOG_SET_LEVEL(Logger::Level::Error);
+    COMPLOG_DEBUG   ("Filtered out", ++evaluationsCount);
+    COMPLOG_WARNING ("Filtered out", ++evaluationsCount);
+    COMPLOG_SET_LEVEL(Logger::Level::Debug);
+    EXPECT_EQ(evaluationsCount, 0) << "Arguments of filtered out log calls must not be evaluated";
+}
+
+TEST(LoggerComponent, SiteLevel) {
+    auto inst = Logger::InstanceBase::createInstance<Logger::Instance>({});
+    inst->setLevel(Logger::Level::Warning);
+
+    const Logger::CallSite networkSite {Logger::Level::Debug, "src/network/socket.cpp", 10};
+    const Logger::CallSite otherNetworkSite {Logger::Level::Debug, "src/network/socket.cpp", 20};
+    const Logger::CallSite uiSite {Logger::Level::Debug, "src/ui/window.cpp", 10};
+    EXPECT_FALSE(inst->isEnabledAt(networkSite));
+
+    // Правило для файла открывает Debug только его местам вызова
+    inst->setSiteLevel("network/socket.cpp", 0, Logger::Level::Debug);
+    EXPECT_TRUE (inst->isEnabledAt(networkSite));
+    EXPECT_TRUE (inst->isEnabledAt(otherNetworkSite));
+    EXPECT_FALSE(inst->isEnabledAt(uiSite));
+
+    // Правило для строки важнее правила для файла
+    inst->setSiteLevel("network/socket.cpp", 20, Logger::Level::Error);
+    EXPECT_TRUE (inst->isEnabledAt(networkSite));
+    EXPECT_FALSE(inst->isEnabledAt(otherNetworkSite));
+
+    inst->clearSiteLevels();
+    EXPECT_FALSE(inst->isEnabledAt(networkSite));
+    EXPECT_FALSE(inst->isEnabledAt(otherNetworkSite));
+}
+
+TEST(LoggerComponent, SiteLocation) {
+    static_assert(Logger::getCallerFunction("main()::<lambda()>::<lambda()>") == "main()");
+
+    const auto& site = COMPLOG_PRIVATE_CALLSITE(Info);
+    const auto line = static_cast<unsigned>(__LINE__ - 1);
+    EXPECT_EQ(site.line, line);
+    EXPECT_TRUE(std::string_view(site.file).ends_with("test_regular.cpp"));
+    EXPECT_NE(site.function.find("SiteLocation"), std::string_view::npos) << site.function;
+    EXPECT_EQ(site.function.find("lambda"), std::string_view::npos) << site.function;
+
+    const std::string testDirpath {"test_location"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+    std::string logfilePath;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        logfilePath = inst->getFilewriter().getLogfilePath();
+        inst->logAt<Logger::Level::Info, false>(site, "Hidden");
+        inst->flush();
+        inst->setShowLocation(true);
+        inst->logAt<Logger::Level::Info, false>(site, "Located", 1);
+        inst->flush();
+    }
+
+    std::ifstream reader(logfilePath);
+    const std::string text {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+    EXPECT_NE(text.find(" Hidden \n"), std::string::npos);
+    EXPECT_NE(text.find(" Located 1 (" + std::string(site.file) + ":" + std::to_string(line) + ") \n"), std::string::npos);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerComponent, LevelSampling) {
+    const std::string testDirpath {"test_sampling"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    static constexpr int RECORDS_COUNT {20000};
+    static constexpr std::uint32_t SAMPLE_RATE {10};
+
+    std::string logfilePath;
+    int evaluationsCount {0};
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+#ifndef COMPONENTS_IS_ENABLED_QT
+        inst->getConsoleSink().setLevel(Logger::Level::Error);
+#endif // COMPONENTS_IS_ENABLED_QT
+        logfilePath = inst->getFilewriter().getLogfilePath();
+        inst->setSampling(Logger::Level::Debug, SAMPLE_RATE);
+
+        const Logger::CallSite site {Logger::Level::Debug, __FILE__, __LINE__};
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            if (inst->isEnabledAt(site)) {
+                inst->logAt<Logger::Level::Debug, false>(site, "Sampled", ++evaluationsCount);
+            }
+        }
+        inst->log<Logger::Level::Info, false>("NotSampled");
+        inst->flush();
+    }
+
+    // Биномиальное распределение: 2000 ± 5 сигм
+    EXPECT_GT(evaluationsCount, RECORDS_COUNT / SAMPLE_RATE - 250);
+    EXPECT_LT(evaluationsCount, RECORDS_COUNT / SAMPLE_RATE + 250);
+
+    std::ifstream reader(logfilePath);
+    int sampledCount {0};
+    int plainCount {0};
+    for (std::string line; std::getline(reader, line);) {
+        if (line.find(" [ DEBG ]  (sampled 1/10) Sampled ") != std::string::npos) {
+            ++sampledCount;
+        } else if (line.find(" [ INFO ]  NotSampled ") != std::string::npos) {
+            ++plainCount;
+        }
+    }
+    EXPECT_EQ(sampledCount, evaluationsCount) << "Every written record is marked, arguments of dropped ones are not evaluated";
+    EXPECT_EQ(plainCount, 1);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+TEST(LoggerComponent, MixedSyncAsyncWriters) {
+    const std::string testDirpath {"test_mixed"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    static constexpr int THREADS_COUNT {4};
+    static constexpr int RECORDS_PER_THREAD {500};
+
+    std::ostringstream capturedOut;
+    auto* const coutBuf = std::cout.rdbuf(capturedOut.rdbuf());
+
+    std::string logfilePath;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->getConsoleWriter().setColorMode(LoggerNoQt::ConsoleWriter::ColorMode::Never);
+        logfilePath = inst->getFilewriter().getLogfilePath();
+
+        static constexpr Logger::CallSite site {Logger::Level::Info, __FILE__, __LINE__};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS_COUNT; ++t) {
+            threads.emplace_back([&inst, t] {
+                for (int i = 0; i < RECORDS_PER_THREAD; ++i) {
+                    if (i % 2) {
+                        inst->logAt<Logger::Level::Info, true>(site, "Mixed", t, i, "sync");
+                    } else {
+                        inst->logAt<Logger::Level::Info, false>(site, "Mixed", t, i, "async");
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        inst->flush();
+    }
+    std::cout.rdbuf(coutBuf);
+
+    std::ifstream reader(logfilePath);
+    ASSERT_TRUE(reader.is_open()) << "Failed to open log file: " << logfilePath;
+    const std::regex lineRegex(R"(^.* \[ INFO \]  Mixed (\d+) (\d+) (sync|async) ?$)");
+    int linesCount {0};
+    for (std::string line; std::getline(reader, line); ++linesCount) {
+        std::smatch match;
+        ASSERT_TRUE(std::regex_match(line, match, lineRegex)) << "Torn line: " << line;
+        EXPECT_EQ(std::stoi(match[2]) % 2 != 0, match[3] == "sync") << line;
+    }
+    EXPECT_EQ(linesCount, THREADS_COUNT * RECORDS_PER_THREAD);
+
+    const auto consoleOutput = capturedOut.str();
+    EXPECT_EQ(std::count(consoleOutput.begin(), consoleOutput.end(), '\n'), THREADS_COUNT * RECORDS_PER_THREAD);
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerComponent, ConsoleWriterBuffering) {
+    std::ostringstream capturedOut;
+    std::ostringstream capturedErr;
+    auto* const coutBuf = std::cout.rdbuf(capturedOut.rdbuf());
+    auto* const cerrBuf = std::cerr.rdbuf(capturedErr.rdbuf());
+
+    auto makeRecord = [](Logger::Level lt, std::string_view body) {
+        return Logger::FormattedRecord {lt, {}, "ts", body};
+    };
+
+    LoggerNoQt::ConsoleWriter writer;
+    writer.setColorMode(LoggerNoQt::ConsoleWriter::ColorMode::Never);
+    writer.write(makeRecord(Logger::Level::Info, "Plain \n"));
+    const bool bufferedUntilFlush = capturedOut.str().empty();
+    writer.flush();
+    const std::string plain = capturedOut.str();
+
+    writer.setColorMode(LoggerNoQt::ConsoleWriter::ColorMode::Always);
+    writer.write(makeRecord(Logger::Level::Info, "Colored \n"));
+    writer.write(makeRecord(Logger::Level::Error, "Error \n"));
+    const std::string colored = capturedOut.str().substr(plain.size());
+    const std::string error = capturedErr.str();
+
+    std::cout.rdbuf(coutBuf);
+    std::cerr.rdbuf(cerrBuf);
+
+    EXPECT_TRUE(bufferedUntilFlush) << "Console output must be flushed on batch boundary, not per record";
+    EXPECT_EQ(plain, "ts [ INFO ]  Plain \n");
+    EXPECT_EQ(colored.find("Colored"), colored.size() - 9) << "Pending stdout must be written before an error";
+    EXPECT_NE(colored.find('\033'), std::string::npos);
+    EXPECT_NE(error.find("Error"), std::string::npos) << "Errors must be written without waiting for flush";
+}
+#endif // COMPONENTS_IS_ENABLED_QT
+
+TEST(LoggerComponent, ArgumentFormatting) {
+    // Форматирование через std::to_chars должно совпадать с выводом std::ostream
+    Logger::TextBuffer buffer;
+    std::ostringstream expected;
+    auto check = [&buffer, &expected](const auto& v) {
+        buffer.clear();
+        buffer.appendArg(v);
+        expected.str({});
+        expected << v << ' ';
+        EXPECT_EQ(std::string(buffer.data(), buffer.size()), expected.str());
+    };
+
+    check(std::int64_t {0});
+    check(std::int64_t {-1234567890123});
+    check(std::numeric_limits<std::int64_t>::min());
+    check(std::numeric_limits<std::uint64_t>::max());
+    check(0.0);
+    check(-3.14159265);
+    check(1e-7);
+    check(123456789.0);
+    check(std::numeric_limits<double>::infinity());
+    check('x');
+    check(std::string_view("text"));
+    check(static_cast<const void*>(&buffer));
+    check(static_cast<const void*>(nullptr));
+
+    buffer.clear();
+    buffer.appendArg(true);
+    buffer.appendArg(false);
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), "true false ");
+}
+
+TEST(LoggerComponent, FunctionPointerFormatting) {
+    // Адрес функции сохраняется как указатель и выводится так же, как адрес объекта
+    void (*callback)(int) = [](int) {};
+    Logger::Record record;
+    record.assign(Logger::Level::Info, callback);
+    Logger::TextBuffer buffer;
+    record.visitArgs([&buffer](const auto& v) {
+        buffer.appendArg(v);
+    });
+    std::ostringstream expected;
+    expected << reinterpret_cast<const void*>(callback) << ' ';
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), expected.str());
+}
+
+TEST(LoggerComponent, EnumFormatting) {
+    // Перечисление без пользовательского вывода сохраняется числом, иначе используется operator<< или ArgFormatter
+    Logger::Record record;
+    record.assign(Logger::Level::Info, PlainState::Idle, StreamedState::Running, FormattedState::Stopped);
+    Logger::TextBuffer buffer;
+    record.visitArgs([&buffer](const auto& v) {
+        buffer.appendArg(v);
+    });
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), "3 Running Stopped ");
+}
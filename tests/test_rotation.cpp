@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief writeRotatedLogs Записать синхронно count записей при заданной ротации
+ * @return                 Файлы директории, отсортированные по времени изменения
+ */
+std::vector<std::filesystem::path> writeRotatedLogs(const std::string& dirpath, const Logger::RotationPolicy& policy, int count) {
+    std::filesystem::remove_all(dirpath);
+    std::filesystem::create_directory(dirpath);
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(dirpath);
+        inst->getFilewriter().setRotation(policy);
+        for (int i = 0; i < count; ++i) {
+            inst->log<Logger::Level::Info, true>("RotatedRecord", i);
+        }
+    }
+
+    // Удаление выполняется в фоне и завершается при уничтожении инстанции
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dirpath)) {
+        files.push_back(entry.path());
+    }
+    return files;
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream reader(path);
+    return {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+}
+
+}
+
+TEST(LoggerRotation, MaxFilesRetained) {
+    Logger::RotationPolicy policy;
+    policy.maxFileSize = 256;
+    policy.maxFiles = 3;
+    const auto files = writeRotatedLogs("test_rotation", policy, 100);
+
+    ASSERT_EQ(files.size(), 3u);
+    bool hasLastRecord {false};
+    for (const auto& file : files) {
+        EXPECT_LE(std::filesystem::file_size(file), policy.maxFileSize) << file;
+        hasLastRecord = hasLastRecord || readFile(file).find("RotatedRecord 99 \n") != std::string::npos;
+    }
+    EXPECT_TRUE(hasLastRecord) << "Newest records must be retained";
+}
+
+TEST(LoggerRotation, MaxTotalSizeRetained) {
+    Logger::RotationPolicy policy;
+    policy.maxFileSize = 256;
+    policy.maxTotalSize = 1024;
+    const auto files = writeRotatedLogs("test_rotation_total", policy, 100);
+
+    std::uint64_t totalSize {0};
+    for (const auto& file : files) {
+        totalSize += std::filesystem::file_size(file);
+    }
+    EXPECT_GT(files.size(), 1u);
+    EXPECT_LE(totalSize, policy.maxTotalSize);
+}
+
+TEST(LoggerRotation, HourlyBoundary) {
+    std::tm timeParts {};
+    timeParts.tm_year = 2026 - 1900;
+    timeParts.tm_mon = 0;
+    timeParts.tm_mday = 15;
+    timeParts.tm_hour = 10;
+    timeParts.tm_min = 59;
+    timeParts.tm_sec = 59;
+    timeParts.tm_isdst = -1;
+    const auto beforeBoundary = std::chrono::system_clock::from_time_t(std::mktime(&timeParts));
+
+    Logger::RotationSchedule schedule;
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary));
+    schedule.setInterval(Logger::RotationInterval::Hourly);
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary)) << "Changing interval must not rotate";
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::milliseconds(999)));
+    EXPECT_TRUE (schedule.isBoundaryCrossed(beforeBoundary + std::chrono::seconds(1)));
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::minutes(30)));
+    EXPECT_TRUE (schedule.isBoundaryCrossed(beforeBoundary + std::chrono::minutes(61)));
+
+    schedule.setInterval(Logger::RotationInterval::Daily);
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::hours(2)));
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::hours(12)));
+    EXPECT_TRUE (schedule.isBoundaryCrossed(beforeBoundary + std::chrono::hours(14)));
+
+    schedule.setInterval(Logger::RotationInterval::None);
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::hours(48)));
+    EXPECT_FALSE(schedule.isBoundaryCrossed(beforeBoundary + std::chrono::hours(96)));
+}
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+TEST(LoggerRotation, RetentionAcrossTimeRotation) {
+    const std::string testDirpath {"test_rotation_hourly"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    Logger::RotationPolicy policy;
+    policy.maxFiles = 3;
+    const auto start = std::chrono::system_clock::now();
+
+    // Ротация по времени задаёт новый логфайл так же, как Instance при переходе границы часа
+    {
+        LoggerNoQt::FileWriter writer;
+        writer.setRotation(policy);
+        for (int hour = 0; hour < 6; ++hour) {
+            writer.setLogfile(testDirpath + "/" + Logger::createLogfileName(start + std::chrono::hours(hour)));
+            const std::string record {"HourlyRecord " + std::to_string(hour) + " \n"};
+            writer.write(record.data(), record.size());
+        }
+    }
+
+    std::vector<std::string> texts;
+    for (const auto& entry : std::filesystem::directory_iterator(testDirpath)) {
+        texts.push_back(readFile(entry.path()));
+    }
+    ASSERT_EQ(texts.size(), 3u);
+    for (int hour = 3; hour < 6; ++hour) {
+        const std::string record {"HourlyRecord " + std::to_string(hour) + " \n"};
+        EXPECT_NE(std::find(texts.begin(), texts.end(), record), texts.end()) << "Newest files must be retained";
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+#endif // COMPONENTS_IS_ENABLED_QT
+
+TEST(LoggerRotation, RetentionAfterRestart) {
+    const std::string testDirpath {"test_rotation_restart"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    // Файлы прежних запусков и файлы, созданные не логгером
+    const std::vector<std::string> previousRuns {
+        "2020-01-01_00-00-00.log", "2020-01-01_00-00-00.1.log", "2020-01-01_00-00-00.2.log",
+        "2020-01-01_00-00-00.10.log", "2020-01-02_00-00-00.log"};
+    const std::vector<std::string> foreignFiles {"notes.log", "2020-01-01_00-00-00.txt", "2020-01-01_00-00-00.x.log"};
+    for (const auto& name : previousRuns) {
+        std::ofstream(testDirpath + "/" + name) << name << "\n";
+    }
+    for (const auto& name : foreignFiles) {
+        std::ofstream(testDirpath + "/" + name) << name << "\n";
+    }
+
+    Logger::RotationPolicy policy;
+    policy.maxFiles = 3;
+    policy.retainPreviousRuns = true;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->getFilewriter().setRotation(policy);
+        inst->log<Logger::Level::Info, true>("RestartRecord");
+    }
+
+    // Хранятся текущий файл и два новейших файла прежних запусков
+    EXPECT_FALSE(std::filesystem::exists(testDirpath + "/2020-01-01_00-00-00.log"));
+    EXPECT_FALSE(std::filesystem::exists(testDirpath + "/2020-01-01_00-00-00.1.log"));
+    EXPECT_FALSE(std::filesystem::exists(testDirpath + "/2020-01-01_00-00-00.2.log"));
+    EXPECT_TRUE (std::filesystem::exists(testDirpath + "/2020-01-01_00-00-00.10.log"));
+    EXPECT_TRUE (std::filesystem::exists(testDirpath + "/2020-01-02_00-00-00.log"));
+    for (const auto& name : foreignFiles) {
+        EXPECT_TRUE(std::filesystem::exists(testDirpath + "/" + name)) << name;
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+TEST(LoggerRotation, ForeignFilesKeptByDefault) {
+    const std::string testDirpath {"test_rotation_foreign"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    // Файлы прежнего запуска и другого логгера той же директории
+    const std::vector<std::string> previousRuns {"2020-01-01_00-00-00.log", "2020-01-01_00-00-00.1.log"};
+    for (const auto& name : previousRuns) {
+        std::ofstream(testDirpath + "/" + name) << name << "\n";
+    }
+
+    Logger::RotationPolicy policy;
+    policy.maxFileSize = 256;
+    policy.maxFiles = 2;
+    {
+        auto other = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        other->log<Logger::Level::Info, true>("OtherRecord");
+        const auto otherPath = std::string(other->getFilewriter().getLogfilePath());
+
+        LoggerNoQt::FileWriter writer;
+        writer.setRotation(policy);
+        writer.setLogfile(testDirpath + "/2021-01-01_00-00-00.log");
+        for (int i = 0; i < 100; ++i) {
+            const std::string record {"RotatedRecord " + std::to_string(i) + " \n"};
+            writer.write(record.data(), record.size());
+        }
+        EXPECT_TRUE(std::filesystem::exists(otherPath)) << "Live file of another logger must be kept";
+    }
+
+    for (const auto& name : previousRuns) {
+        EXPECT_TRUE(std::filesystem::exists(testDirpath + "/" + name)) << name;
+    }
+    std::size_t ownFiles {0};
+    for (const auto& entry : std::filesystem::directory_iterator(testDirpath)) {
+        ownFiles += entry.path().filename().string().starts_with("2021-01-01_00-00-00") ? 1 : 0;
+    }
+    EXPECT_EQ(ownFiles, policy.maxFiles);
+
+    std::filesystem::remove_all(testDirpath);
+}
+#endif // COMPONENTS_IS_ENABLED_QT
@@ -0,0 +1,455 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef COMPONENTS_IS_ENABLED_QT
+namespace
+{
+
+/**
+ * @brief The GatedSink class Приёмник, выводящий записи только после открытия шлюза
+ */
+class GatedSink final : public Logger::Sink
+{
+public:
+    std::atomic<bool> isOpen {true};
+
+    std::vector<std::string> getWritten() {
+        std::lock_guard lock(m_mx);
+        return m_written;
+    }
+
+    void write(const Logger::FormattedRecord& record) override {
+        while (!isOpen.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        std::lock_guard lock(m_mx);
+        m_written.emplace_back(record.body);
+    }
+
+private:
+    std::mutex m_mx;
+    std::vector<std::string> m_written;
+};
+
+/**
+ * @brief The FailingSink class Приёмник, бросающий исключение на записях с заданным текстом
+ */
+class FailingSink final : public Logger::Sink
+{
+public:
+    void write(const Logger::FormattedRecord& record) override {
+        if (record.body.find("Bad") != std::string_view::npos) {
+            throw std::runtime_error("Sink failed");
+        }
+    }
+};
+
+/**
+ * @brief The GatedStreambuf class Поток вывода, принимающий данные только после открытия шлюза (зависший терминал)
+ */
+class GatedStreambuf final : public std::streambuf
+{
+public:
+    std::atomic<bool> isOpen {false};
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        waitOpen();
+        return count;
+    }
+
+    int_type overflow(int_type ch) override {
+        waitOpen();
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    void waitOpen() {
+        while (!isOpen.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+};
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream reader(path);
+    return std::string {std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>()};
+}
+
+std::size_t countLines(const std::string& path)
+{
+    std::ifstream reader(path);
+    return std::count(std::istreambuf_iterator<char>(reader), std::istreambuf_iterator<char>(), '\n');
+}
+
+constexpr int RECORDS_COUNT {100};
+
+#ifdef __linux__
+std::size_t countThreads()
+{
+    const std::filesystem::directory_iterator tasks {"/proc/self/task"};
+    return static_cast<std::size_t>(std::distance(begin(tasks), end(tasks)));
+}
+#endif // __linux__
+
+}
+
+TEST(LoggerSinks, SlowSinkDoesNotDelayLogfile) {
+    const std::string testDirpath {"test_sinks"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    auto sink = std::make_shared<GatedSink>();
+    sink->isOpen.store(false);
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->getConsoleSink().setLevel(Logger::Level::Error);
+        inst->addSink(sink);
+        const std::string logfilePath {inst->getFilewriter().getLogfilePath()};
+
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            inst->log<Logger::Level::Info, false>("Record", i);
+        }
+        // Логфайл выводится, пока пользовательский приёмник стоит
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (countLines(logfilePath) < RECORDS_COUNT && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(countLines(logfilePath), static_cast<std::size_t>(RECORDS_COUNT));
+        EXPECT_TRUE(sink->getWritten().empty());
+        EXPECT_FALSE(inst->flush(std::chrono::milliseconds(20)));
+
+        sink->isOpen.store(true);
+        EXPECT_TRUE(inst->flush(std::chrono::seconds(5)));
+        const auto written = sink->getWritten();
+        ASSERT_EQ(written.size(), static_cast<std::size_t>(RECORDS_COUNT));
+        EXPECT_EQ(written.front(), "Record 0 \n");
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerSinks, StalledConsoleDoesNotDelayLogfile) {
+    static constexpr int STALL_RECORDS_COUNT {2000};
+
+    const std::string testDirpath {"test_sinks"};
+    for (const bool isPooled : {false, true}) {
+        std::filesystem::remove_all(testDirpath);
+        ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+        GatedStreambuf console;
+        const auto previousBuffer = std::cout.rdbuf(&console);
+        {
+            // Инстанция сохраняет пул после его сброса
+            Logger::InstanceBase::setSharedWorkers(isPooled ? 1 : 0);
+            auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+            Logger::InstanceBase::setSharedWorkers(0);
+            inst->getConsoleSink().setBufferLimit(16 * 1024);
+            const std::string logfilePath {inst->getFilewriter().getLogfilePath()};
+
+            for (int i = 0; i < STALL_RECORDS_COUNT; ++i) {
+                inst->log<Logger::Level::Info, false>("Record", i);
+            }
+            // Консоль стоит, логфайл получает все записи и сводку отброшенных консолью
+            auto isLogfileComplete = [&logfilePath]() {
+                const auto text = readFile(logfilePath);
+                return text.find("Record " + std::to_string(STALL_RECORDS_COUNT - 1) + " \n") != std::string::npos &&
+                       text.find("Console output: dropped") != std::string::npos;
+            };
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!isLogfileComplete() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            EXPECT_TRUE(isLogfileComplete()) << (isPooled ? "pooled" : "own worker");
+            EXPECT_GT(inst->getConsoleSink().getDroppedCount(), 0u);
+
+            console.isOpen.store(true);
+            EXPECT_TRUE(inst->flush(std::chrono::seconds(5)));
+        }
+        std::cout.rdbuf(previousBuffer);
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+
+TEST(LoggerSinks, SinkErrorDoesNotStopOtherSinks) {
+    static constexpr int BAD_EVERY {10};
+
+    const std::string missingDirpath {"test_sinks_missing"};
+    std::filesystem::remove_all(missingDirpath);
+    for (const bool isPooled : {false, true}) {
+        Logger::InstanceBase::setSharedWorkers(isPooled ? 1 : 0);
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(missingDirpath);
+        Logger::InstanceBase::setSharedWorkers(0);
+        inst->getConsoleSink().setLevel(Logger::Level::Error);
+
+        // Ошибающийся приёмник - перед собирающим: записи, на которых он бросает, всё равно выводятся дальше.
+        // Логфайл в несуществующем каталоге не открывается (у инстанции пула - в потоке пула)
+        auto failing = std::make_shared<FailingSink>();
+        auto& failingChannel = inst->addSink(failing);
+        auto collecting = std::make_shared<GatedSink>();
+        inst->addSink(collecting);
+
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            inst->log<Logger::Level::Info, false>(i % BAD_EVERY == 0 ? "Bad" : "Good", i);
+        }
+        ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+
+        // Сводки отброшенных записей выводятся между пакетами
+        auto written = collecting->getWritten();
+        written.erase(std::remove_if(written.begin(), written.end(), [](const std::string& v) {
+                          return v.rfind("Sink output: dropped", 0) == 0;
+                      }),
+                      written.end());
+        ASSERT_EQ(written.size(), static_cast<std::size_t>(RECORDS_COUNT)) << (isPooled ? "pooled" : "own worker");
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            EXPECT_EQ(written[i], std::string(i % BAD_EVERY == 0 ? "Bad " : "Good ") + std::to_string(i) + " \n");
+        }
+        EXPECT_EQ(failingChannel.getDroppedCount(), static_cast<std::uint64_t>(RECORDS_COUNT / BAD_EVERY));
+        EXPECT_NE(failingChannel.getLastError(), nullptr);
+        EXPECT_GT(inst->getLogfileSink().getDroppedCount(), 0u);
+        EXPECT_NE(inst->getLogfileSink().getLastError(), nullptr);
+
+        // Синхронная запись выводится остальными приёмниками, вызывающий получает ошибку
+        EXPECT_THROW((inst->log<Logger::Level::Info, true>("Bad", "sync")), std::runtime_error);
+        EXPECT_EQ(collecting->getWritten().back(), "Bad sync \n");
+        inst->removeSink(failing);
+        inst->removeSink(inst->getLogfileSink().getSink());
+    }
+}
+
+TEST(LoggerSinks, LevelFilterAndOverflow) {
+    auto inst = Logger::InstanceBase::createInstance<Logger::Instance>({});
+    inst->removeSink(inst->getLogfileSink().getSink());
+    inst->getConsoleSink().setLevel(Logger::Level::Error);
+
+    auto warnings = std::make_shared<GatedSink>();
+    inst->addSink(warnings).setLevel(Logger::Level::Warning);
+
+    auto dropping = std::make_shared<GatedSink>();
+    dropping->isOpen.store(false);
+    auto& droppingChannel = inst->addSink(dropping, Logger::OverflowPolicy::DropNewest);
+    droppingChannel.setBufferLimit(256);
+
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        inst->log<Logger::Level::Info, false>("Info", i);
+        inst->log<Logger::Level::Warning, false>("Warning", i);
+    }
+    dropping->isOpen.store(true);
+    ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+
+    // Кроме записей Warning - сводки отброшенных переполненным приёмником
+    const auto written = warnings->getWritten();
+    std::size_t warningsCount {0};
+    std::uint64_t reportedDropped {0};
+    const std::regex summary {"Sink output: dropped ([0-9]+) records \n"};
+    for (const auto& v : written) {
+        std::smatch match;
+        if (v.rfind("Warning", 0) == 0) {
+            ++warningsCount;
+        } else if (std::regex_match(v, match, summary)) {
+            reportedDropped += std::stoull(match[1]);
+        } else {
+            ADD_FAILURE() << v;
+        }
+    }
+    EXPECT_EQ(warningsCount, static_cast<std::size_t>(RECORDS_COUNT));
+
+    EXPECT_GT(droppingChannel.getDroppedCount(), 0u);
+    EXPECT_EQ(reportedDropped, droppingChannel.getDroppedCount());
+    EXPECT_EQ(dropping->getWritten().size() + droppingChannel.getDroppedCount(), static_cast<std::size_t>(2 * RECORDS_COUNT));
+
+    const auto writtenCount = written.size();
+    inst->removeSink(warnings);
+    inst->log<Logger::Level::Warning, false>("Removed");
+    inst->flush();
+    EXPECT_EQ(warnings->getWritten().size(), writtenCount);
+}
+
+TEST(LoggerSinks, JsonLinesFields) {
+    const std::string testDirpath {"test_sinks_json"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+    const std::string jsonPath {testDirpath + "/records.jsonl"};
+
+    std::string logfilePath;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->getConsoleSink().setLevel(Logger::Level::Error);
+        inst->addSink(std::make_shared<Logger::JsonLinesSink>(jsonPath));
+        logfilePath = inst->getFilewriter().getLogfilePath();
+
+        inst->logKv<Logger::Level::Info, false>("Request done", "status", 200, "elapsed_ms", 12.5,
+                                                "path", "/a\"b\n", "cached", true);
+        inst->log<Logger::Level::Warning, false>("Plain", 1);
+        // Синхронная запись не упорядочена с ещё не выведенными асинхронными
+        ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+        inst->logKv<Logger::Level::Error, true>("Sync", "user", std::string("root"));
+        ASSERT_TRUE(inst->flush(std::chrono::seconds(5)));
+    }
+
+    std::ifstream reader(jsonPath);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(reader, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    const std::regex tsPrefix(R"(^\{"ts":"\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}",)");
+    for (const auto& line : lines) {
+        EXPECT_TRUE(std::regex_search(line, tsPrefix)) << line;
+    }
+    auto tail = [](const std::string& line) {
+        return line.substr(line.find("\"level\""));
+    };
+    EXPECT_EQ(tail(lines[0]), R"("level":"Info","msg":"Request done","status":200,"elapsed_ms":12.5,"path":"/a\"b\n","cached":true})");
+    EXPECT_EQ(tail(lines[1]), R"("level":"Warning","msg":"Plain 1"})");
+    EXPECT_EQ(tail(lines[2]), R"("level":"Error","msg":"Sync","user":"root"})");
+
+    // В текстовом логфайле поля выводятся как name=value
+    std::ifstream logfile(logfilePath);
+    const std::string text {std::istreambuf_iterator<char>(logfile), std::istreambuf_iterator<char>()};
+    EXPECT_NE(text.find("Request done status=200 elapsed_ms=12.5 path=/a\"b\n cached=true \n"), std::string::npos);
+
+    std::filesystem::remove_all(testDirpath);
+}
+TEST(LoggerSinks, AlternativeFileWriters) {
+    const std::string testDirpath {"test_sinks_files"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    std::string logfilePath;
+    std::vector<std::string> sinkPaths;
+    {
+        auto inst = Logger::InstanceBase::createInstance<Logger::Instance>(testDirpath);
+        inst->getConsoleSink().setLevel(Logger::Level::Error);
+        logfilePath = inst->getFilewriter().getLogfilePath();
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+        sinkPaths.push_back(testDirpath + "/mapped.txt");
+        inst->addSink(std::make_shared<Logger::MappedFileSink>(sinkPaths.back(), 64 * 1024));
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+        sinkPaths.push_back(testDirpath + "/async.txt");
+        inst->addSink(std::make_shared<Logger::AsyncFileSink>(sinkPaths.back()));
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
+
+        for (int i = 0; i < RECORDS_COUNT; ++i) {
+            inst->log<Logger::Level::Info, false>("FileSinkRecord", i);
+        }
+    }
+
+    // Приёмники выводят те же строки, что и основной логфайл
+    const auto text = readFile(logfilePath);
+    EXPECT_EQ(countLines(logfilePath), static_cast<std::size_t>(RECORDS_COUNT));
+    for (const auto& path : sinkPaths) {
+        EXPECT_EQ(readFile(path), text) << path;
+    }
+
+    std::filesystem::remove_all(testDirpath);
+}
+#ifdef COMPLOG_PRIVATE_HAS_MAPPED_FILE
+TEST(LoggerSinks, MappedFileZeroTailTrimmed) {
+    const std::string testDirpath {"test_sinks_mapped"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+    const std::string crashedPath {testDirpath + "/crashed.txt"};
+    const std::string firstRecord {"Record before crash\n"};
+    const std::string secondRecord {"Record after restart\n"};
+
+    // Копия незакрытого файла повторяет файл после аварии: текст и нулевой хвост блока
+    {
+        Logger::MappedFileWriter writer(64 * 1024);
+        writer.setLogfile(testDirpath + "/open.txt");
+        writer.write(firstRecord.data(), firstRecord.size());
+        std::filesystem::copy_file(testDirpath + "/open.txt", crashedPath);
+    }
+    ASSERT_GT(std::filesystem::file_size(crashedPath), firstRecord.size());
+
+    {
+        Logger::MappedFileWriter writer(64 * 1024);
+        writer.setLogfile(crashedPath);
+        writer.write(secondRecord.data(), secondRecord.size());
+    }
+    EXPECT_EQ(readFile(crashedPath), firstRecord + secondRecord);
+
+    std::filesystem::remove_all(testDirpath);
+}
+#endif // COMPLOG_PRIVATE_HAS_MAPPED_FILE
+#ifdef __linux__
+TEST(LoggerSinks, PooledInstancesStartNoSinkThreads) {
+    static constexpr int INSTANCES_COUNT {20};
+
+    const std::string testDirpath {"test_sinks"};
+    std::filesystem::remove_all(testDirpath);
+    ASSERT_TRUE(std::filesystem::create_directory(testDirpath));
+
+    Logger::InstanceBase::setSharedWorkers(2);
+    const auto baseline = countThreads();
+    {
+        std::vector<std::shared_ptr<Logger::Instance>> instances;
+        for (int i = 0; i < INSTANCES_COUNT; ++i) {
+            const auto dirpath = testDirpath + "/" + std::to_string(i);
+            ASSERT_TRUE(std::filesystem::create_directory(dirpath));
+            instances.push_back(Logger::InstanceBase::createInstance<Logger::Instance>(dirpath));
+            instances.back()->getConsoleSink().setLevel(Logger::Level::Error);
+        }
+        EXPECT_EQ(countThreads(), baseline);
+
+        for (auto& inst : instances) {
+            for (int i = 0; i < RECORDS_COUNT; ++i) {
+                inst->log<Logger::Level::Info, false>("Record", i);
+            }
+        }
+        for (auto& inst : instances) {
+            EXPECT_TRUE(inst->flush(std::chrono::seconds(5)));
+            EXPECT_EQ(countLines(std::string(inst->getFilewriter().getLogfilePath())), static_cast<std::size_t>(RECORDS_COUNT));
+        }
+        EXPECT_EQ(countThreads(), baseline);
+
+        // Добавленный пользователем приёмник сохраняет свой поток
+        auto sink = std::make_shared<GatedSink>();
+        instances.front()->addSink(sink);
+        EXPECT_EQ(countThreads(), baseline + 1);
+        instances.front()->removeSink(sink);
+    }
+    Logger::InstanceBase::setSharedWorkers(0);
+
+    std::filesystem::remove_all(testDirpath);
+}
+#endif // __linux__
+
+#ifdef COMPLOG_PRIVATE_HAS_ASYNC_FILE
+TEST(LoggerSinks, AsyncFileWriteErrorReported) {
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP() << "/dev/full is not available";
+    }
+
+    // Запись в /dev/full завершается ENOSPC: потерянные данные сообщаются исключением, а не теряются молча
+    for (auto backend : {Logger::AsyncFileWriter::Backend::Auto, Logger::AsyncFileWriter::Backend::Blocking}) {
+        Logger::AsyncFileWriter writer(backend);
+        writer.setLogfile(std::string("/dev/full"));
+        const std::string record {"Lost record\n"};
+        writer.write(record.data(), record.size());
+        EXPECT_THROW(writer.sync(), std::runtime_error);
+        EXPECT_NO_THROW(writer.sync()) << "Error is reported once";
+    }
+}
+#endif // COMPLOG_PRIVATE_HAS_ASYNC_FILE
+#endif // COMPONENTS_IS_ENABLED_QT
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <Components/Logger/Logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief The CountingInstance class Инстанция, считающая выведенные записи и проверяющая их порядок
+ */
+class CountingInstance final : public Logger::InstanceBase
+{
+public:
+    explicit CountingInstance(std::chrono::microseconds writeDelay = {}) :
+        m_writeDelay {writeDelay}
+    {}
+
+    ~CountingInstance() {
+        deinit();
+    }
+
+    std::atomic<int>  writtenCount {0};
+    std::atomic<bool> isOrdered {true};
+
+private:
+    std::chrono::microseconds m_writeDelay;
+    std::int64_t m_lastIndex {-1};
+
+    void init(const std::string&) override {}
+    void writeRecord(const Logger::Record& record) override {
+        if (m_writeDelay.count() > 0) {
+            std::this_thread::sleep_for(m_writeDelay);
+        }
+        record.visitArgs([this](const auto& v) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::int64_t>) {
+                if (v <= m_lastIndex) {
+                    isOrdered.store(false);
+                }
+                m_lastIndex = v;
+            }
+        });
+        writtenCount.fetch_add(1);
+    }
+};
+
+/**
+ * @brief The SharedWorkersGuard class Общий пул на время теста
+ */
+struct SharedWorkersGuard {
+    explicit SharedWorkersGuard(std::size_t threadsCount) {
+        Logger::InstanceBase::setSharedWorkers(threadsCount);
+    }
+    ~SharedWorkersGuard() {
+        Logger::InstanceBase::setSharedWorkers(0);
+    }
+};
+
+#ifdef __linux__
+std::size_t countThreads()
+{
+    const std::filesystem::directory_iterator tasks {"/proc/self/task"};
+    return static_cast<std::size_t>(std::distance(begin(tasks), end(tasks)));
+}
+#endif // __linux__
+
+}
+
+TEST(LoggerWorkerPool, KeepsPerInstanceOrder) {
+    static constexpr int INSTANCES_COUNT {12};
+    static constexpr int RECORDS_COUNT {2000};
+
+    std::vector<std::shared_ptr<CountingInstance>> instances;
+    {
+        SharedWorkersGuard guard(2);
+        for (int i = 0; i < INSTANCES_COUNT; ++i) {
+            instances.push_back(std::make_shared<CountingInstance>());
+        }
+    }
+
+    std::vector<std::thread> producers;
+    for (auto& inst : instances) {
+        producers.emplace_back([&inst] {
+            for (int i = 0; i < RECORDS_COUNT; ++i) {
+                inst->log<Logger::Level::Info, false>("Record", i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    for (auto& inst : instances) {
+        ASSERT_TRUE(inst->flush(std::chrono::seconds(10)));
+        EXPECT_EQ(inst->writtenCount.load(), RECORDS_COUNT);
+        EXPECT_TRUE(inst->isOrdered.load());
+    }
+}
+
+TEST(LoggerWorkerPool, BusyInstanceDoesNotStarveOthers) {
+    static constexpr int BUSY_RECORDS_COUNT {2000};
+
+    SharedWorkersGuard guard(1);
+    // Вывод записи загруженной инстанции занимает ~100 мкс, вся очередь - ~200 мс
+    auto busy = std::make_shared<CountingInstance>(std::chrono::microseconds(100));
+    busy->setBatching(32);
+    auto light = std::make_shared<CountingInstance>();
+
+    for (int i = 0; i < BUSY_RECORDS_COUNT; ++i) {
+        busy->log<Logger::Level::Info, false>("Busy", i);
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    light->log<Logger::Level::Info, false>("Light", 0);
+    ASSERT_TRUE(light->flush(std::chrono::seconds(5)));
+    const auto latency = std::chrono::steady_clock::now() - begin;
+
+    // Запись лёгкой инстанции выводится после текущего пакета загруженной, а не после всей её очереди
+    EXPECT_LT(busy->writtenCount.load(), BUSY_RECORDS_COUNT / 2);
+    EXPECT_LT(latency, std::chrono::milliseconds(100));
+
+    ASSERT_TRUE(busy->flush(std::chrono::seconds(10)));
+    EXPECT_EQ(busy->writtenCount.load(), BUSY_RECORDS_COUNT);
+    EXPECT_TRUE(busy->isOrdered.load());
+}
+
+#ifdef __linux__
+TEST(LoggerWorkerPool, ThreadsCountDoesNotGrowWithInstances) {
+    static constexpr std::size_t THREADS_COUNT {2};
+    static constexpr int INSTANCES_COUNT {16};
+    static constexpr int RECORDS_COUNT {100};
+
+    // Рабочие потоки инстанций предыдущих тестов присоединены при их разрушении
+    const auto baseline = countThreads();
+    SharedWorkersGuard guard(THREADS_COUNT);
+    // Потоки пула и общий поток консоли инстанций пула
+    ASSERT_EQ(countThreads(), baseline + THREADS_COUNT + 1);
+
+    std::vector<std::shared_ptr<CountingInstance>> instances;
+    std::vector<std::shared_ptr<Logger::Instance>> textInstances;
+    for (int i = 0; i < INSTANCES_COUNT; ++i) {
+        instances.push_back(std::make_shared<CountingInstance>());
+        textInstances.push_back(Logger::InstanceBase::createInstance<Logger::Instance>({}));
+        textInstances.back()->getConsoleSink().setLevel(Logger::Level::Error);
+    }
+    EXPECT_EQ(countThreads(), baseline + THREADS_COUNT + 1);
+
+    for (int i = 0; i < RECORDS_COUNT; ++i) {
+        for (auto& inst : instances) {
+            inst->log<Logger::Level::Info, false>("Record", i);
+        }
+    }
+    for (auto& inst : instances) {
+        ASSERT_TRUE(inst->flush(std::chrono::seconds(10)));
+        EXPECT_EQ(inst->writtenCount.load(), RECORDS_COUNT);
+    }
+    EXPECT_EQ(countThreads(), baseline + THREADS_COUNT + 1);
+}
+#endif // __linux__
@@ -0,0 +1,95 @@
+/**
+ * @file logdecoder.cpp Перевод двоичного логфайла (Logger::OutputFormat::Binary) в текстовый формат логгера
+ *
+ * Использование: LoggerDecoder [-f|--follow] [-l|--locations] <logfile.clog>
+ *     -f, --follow     Продолжать чтение по мере записи файла (аналог tail -f)
+ *     -l, --locations  Добавлять к записям место вызова (файл:строка)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "logdecoder.hpp"
+
+using LoggerDecoder::Decoder;
+
+namespace
+{
+
+// Период опроса файла в режиме --follow
+constexpr std::chrono::milliseconds FOLLOW_POLL_INTERVAL {100};
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [-f|--follow] [-l|--locations] <logfile" << Logger::BINARY_LOG_EXTENSION << ">" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bool isFollowing {false};
+    bool printLocations {false};
+    const char* filePath {nullptr};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg {argv[i]};
+        if (arg == "-f" || arg == "--follow") {
+            isFollowing = true;
+        } else if (arg == "-l" || arg == "--locations") {
+            printLocations = true;
+        } else if (!filePath && !arg.empty() && arg.front() != '-') {
+            filePath = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!filePath) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto file = std::fopen(filePath, "rb");
+    if (!file) {
+        std::cerr << "Error opening logfile: " << filePath << std::endl;
+        return 1;
+    }
+
+    Decoder decoder(file, std::cout, printLocations);
+    auto status = decoder.readHeader();
+    while (status == Decoder::Status::EndOfFile && isFollowing) {
+        std::this_thread::sleep_for(FOLLOW_POLL_INTERVAL);
+        std::clearerr(file);
+        std::rewind(file);
+        status = decoder.readHeader();
+    }
+    if (status != Decoder::Status::Ok) {
+        std::cerr << "Invalid binary logfile: " << filePath << std::endl;
+        std::fclose(file);
+        return 1;
+    }
+
+    for (;;) {
+        status = decoder.readEntry();
+        if (status == Decoder::Status::Ok) {
+            continue;
+        }
+
+        if (status == Decoder::Status::Corrupted) {
+            std::cerr << "Corrupted entry in logfile: " << filePath << std::endl;
+            break;
+        }
+
+        if (!isFollowing) {
+            break;
+        }
+        std::cout.flush();
+        std::this_thread::sleep_for(FOLLOW_POLL_INTERVAL);
+    }
+
+    std::fclose(file);
+    return status == Decoder::Status::Corrupted ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+/**
+ * @file logdecoder.hpp Файл с определением чтения двоичного логфайла (Logger::OutputFormat::Binary)
+ *       в текстовом формате логгера
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/common.hpp"
+#include "../src/binaryformat.hpp"
+#include "../src/payload.hpp"
+#include "../src/textbuffer.hpp"
+#include "../src/timestamp.hpp"
+
+namespace LoggerDecoder
+{
+
+/**
+ * @brief The SiteInfo struct Описание места вызова из двоичного логфайла
+ */
+struct SiteInfo
+{
+    Logger::Level level;
+    std::string   file;
+    std::uint32_t line;
+};
+
+/**
+ * @brief The Decoder class Последовательное чтение записей двоичного логфайла
+ */
+class Decoder
+{
+public:
+    /**
+     * @param file              Открытый двоичный логфайл
+     * @param output            Поток вывода текста
+     * @param printLocations    Добавлять к записям место вызова (файл:строка)
+     */
+    Decoder(std::FILE* file, std::ostream& output, bool printLocations) :
+        m_file {file},
+        m_output {output},
+        m_printLocations {printLocations}
+    {
+
+    }
+
+    /**
+     * @brief The Status enum Результат чтения записи
+     */
+    enum class Status { Ok, EndOfFile, Corrupted };
+
+    /**
+     * @brief readHeader Проверить сигнатуру файла
+     */
+    Status readHeader() {
+        char magic[sizeof(Logger::BINARY_LOG_MAGIC)];
+        if (!readBytes(magic, sizeof(magic))) {
+            return Status::EndOfFile;
+        }
+        if (std::memcmp(magic, Logger::BINARY_LOG_MAGIC, sizeof(magic)) != 0) {
+            return Status::Corrupted;
+        }
+        return Status::Ok;
+    }
+
+    /**
+     * @brief readEntry Прочитать и вывести следующую запись
+     * @note            При неполной записи позиция в файле возвращается на её начало
+     */
+    Status readEntry() {
+        const auto entryPos = std::ftell(m_file);
+        auto status = readEntryImpl();
+        if (status == Status::EndOfFile) {
+            std::clearerr(m_file);
+            std::fseek(m_file, entryPos, SEEK_SET);
+        }
+        return status;
+    }
+
+private:
+    std::FILE* m_file;
+    std::ostream& m_output;
+    bool m_printLocations;
+    std::unordered_map<std::uint64_t, SiteInfo> m_sites;
+    std::vector<std::byte> m_payload;
+    Logger::TimestampFormatter m_timestampFormatter;
+    Logger::TextBuffer m_line; //! Текст текущей записи
+
+    bool readBytes(void* data, std::size_t size) {
+        return std::fread(data, 1, size, m_file) == size;
+    }
+
+    template <typename T>
+    bool readValue(T& v) {
+        return readBytes(&v, sizeof(T));
+    }
+
+    Status readEntryImpl() {
+        std::uint8_t entryType;
+        if (!readValue(entryType)) {
+            return Status::EndOfFile;
+        }
+
+        switch (static_cast<Logger::BinaryEntry>(entryType)) {
+        case Logger::BinaryEntry::CallSite:
+            return readCallSite();
+        case Logger::BinaryEntry::Record:
+            return readRecord(false);
+        case Logger::BinaryEntry::SampledRecord:
+            return readRecord(true);
+        }
+        return Status::Corrupted;
+    }
+
+    Status readCallSite() {
+        std::uint64_t siteId;
+        std::uint8_t level;
+        std::uint32_t line;
+        std::uint32_t fileLength;
+        if (!readValue(siteId) || !readValue(level) || !readValue(line) || !readValue(fileLength)) {
+            return Status::EndOfFile;
+        }
+        if (fileLength > Logger::BINARY_MAX_FILE_NAME_SIZE) {
+            return Status::Corrupted;
+        }
+
+        std::string file(fileLength, '\0');
+        std::uint8_t argsCount;
+        if (!readBytes(file.data(), file.size()) || !readValue(argsCount)) {
+            return Status::EndOfFile;
+        }
+
+        // Типы аргументов дублируются в записях, здесь только пропускаются
+        std::uint8_t argTypes[UINT8_MAX];
+        if (!readBytes(argTypes, argsCount)) {
+            return Status::EndOfFile;
+        }
+
+        m_sites[siteId] = SiteInfo {static_cast<Logger::Level>(level), std::move(file), line};
+        return Status::Ok;
+    }
+
+    Status readRecord(bool isSampled) {
+        std::uint64_t siteId;
+        std::uint8_t level;
+        std::int64_t systemNs;
+        std::uint64_t sequence;
+        std::uint32_t payloadSize;
+        std::uint32_t sampleRate {1};
+        if (!readValue(siteId) || !readValue(level) || !readValue(systemNs) ||
+            !readValue(sequence) || !readValue(payloadSize) || (isSampled && !readValue(sampleRate))) {
+            return Status::EndOfFile;
+        }
+        // Размер прочитан из файла: повреждённая запись не должна приводить к выделению гигабайт памяти
+        if (payloadSize > Logger::BINARY_MAX_PAYLOAD_SIZE) {
+            return Status::Corrupted;
+        }
+
+        m_payload.resize(payloadSize);
+        if (!readBytes(m_payload.data(), m_payload.size())) {
+            return Status::EndOfFile;
+        }
+
+        const auto lt = static_cast<Logger::Level>(level);
+        m_line.clear();
+        if (lt != Logger::Level::Empty) {
+            const std::chrono::system_clock::time_point timestamp {
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(systemNs))};
+            char timestampBuffer[Logger::TimestampFormatter::TIMESTAMP_SIZE];
+            m_line.append(timestampBuffer, m_timestampFormatter.format(timestamp, timestampBuffer));
+            m_line.append(Logger::getLevelLabel(lt, false));
+        }
+        if (sampleRate > 1) {
+            m_line.appendSampleRate(sampleRate);
+        }
+
+        // Аргументы форматируются так же, как в текстовом логфайле
+        const auto isValid = Logger::visitPayload(m_payload.data(), m_payload.size(), [this](const auto& v) {
+            m_line.appendArg(v);
+        });
+
+        if (m_printLocations) {
+            auto site = m_sites.find(siteId);
+            if (site != m_sites.end()) {
+                m_line.append('(');
+                m_line.append(site->second.file);
+                m_line.append(':');
+                m_line.append(std::to_string(site->second.line));
+                m_line.append(") ");
+            }
+        }
+        m_line.append('\n');
+        m_output.write(m_line.data(), static_cast<std::streamsize>(m_line.size()));
+
+        return isValid ? Status::Ok : Status::Corrupted;
+    }
+};
+
+}